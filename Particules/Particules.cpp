@@ -1,5 +1,7 @@
 #include "Particules.h"
+#include <algorithm>
 #include <random>
+#include <QMouseEvent>
 #include <QPainter>
 #include <QWheelEvent>
 #include <QDebug>
@@ -33,12 +35,15 @@ Particules::Particules(QWidget* parent)
     r.y1 = urd(dre) * (1.0f - size);
     r.x2 = r.x1 + size;
     r.y2 = r.y1 + size;
-    m_QuadTree.insert(CRect(r.x1, r.y1, r.x2, r.y2));
     m_List.push_back(CRect(r.x1, r.y1, r.x2, r.y2));
+    m_Speeds.push_back(QPointF((urd(dre) - 0.5f) * 0.002f, (urd(dre) - 0.5f) * 0.002f));
   }
+  m_QuadTree.assign(m_List);
 
   m_centerPixel = { width() / 2.0f, height() / 2.0f };
   computeTranslate();
+  //Les rectangles sont pointés au survol, sans qu'un bouton soit enfoncé
+  setMouseTracking(true);
 
   startTimer(1000, Qt::TimerType::PreciseTimer);
 }
@@ -46,8 +51,47 @@ Particules::Particules(QWidget* parent)
 Particules::~Particules()
 {}
 
+void Particules::animate()
+{
+  if (m_Handles.empty())
+  {
+    //Les identifiants ne servent qu'à l'animation : le QuadTree est chargé sans eux au démarrage
+    m_QuadTree.clear();
+    for (const auto& rect : m_List)
+      m_Handles.push_back(m_QuadTree.insertWithHandle(rect));
+  }
+
+  auto speed = m_Speeds.begin();
+  auto handle = m_Handles.begin();
+  for (auto& rect : m_List)
+  {
+    float width = rect.x2() - rect.x1();
+    float height = rect.y2() - rect.y1();
+    float x1 = rect.x1() + static_cast<float>(speed->x());
+    float y1 = rect.y1() + static_cast<float>(speed->y());
+    if (x1 < 0.0f || x1 + width > 1.0f)
+    {
+      speed->rx() = -speed->x();
+      x1 = std::clamp(x1, 0.0f, 1.0f - width);
+    }
+    if (y1 < 0.0f || y1 + height > 1.0f)
+    {
+      speed->ry() = -speed->y();
+      y1 = std::clamp(y1, 0.0f, 1.0f - height);
+    }
+    rect = CRect(x1, y1, x1 + width, y1 + height);
+    //La marge évite de modifier la structure du QuadTree pour la plupart des déplacements
+    m_QuadTree.relocate(*handle, rect, m_Margin);
+    ++speed;
+    ++handle;
+  }
+}
+
 void Particules::paintEvent(QPaintEvent* event)
 {
+  if (m_Animate)
+    animate();
+
   QPainter painter(this);
   painter.setRenderHint(QPainter::Antialiasing);
 
@@ -118,10 +162,34 @@ void Particules::paintEvent(QPaintEvent* event)
       painter.drawRect(*it);
   }
     break;
+  case Particules::EIterAlgorithm::quadTreeInscribedVisitor:
+    m_QuadTree.forEachInscribed(limits, [&painter](const CRect& rect) { painter.drawRect(rect); });
+    break;
+  case Particules::EIterAlgorithm::quadTreeCollidingVisitor:
+    m_QuadTree.forEachColliding(limits, [&painter](const CRect& rect) { painter.drawRect(rect); });
+    break;
   default:
     break;
   }
 
+  //Les rectangles sous la souris sont recherchés à chaque image : ils se déplacent pendant l'animation
+  size_t picked = 0;
+  if (m_Cursor)
+  {
+    const QPointF cursor = pixelToLogical(*m_Cursor);
+    painter.setPen(QPen(Qt::yellow, 0.0));
+    painter.setBrush(QBrush(QColor(255, 255, 0, 64)));
+    m_QuadTree.forEachContaining(static_cast<float>(cursor.x()), static_cast<float>(cursor.y()),
+      [&painter, &picked](const CRect& rect) { painter.drawRect(rect); ++picked; });
+  }
+
+  if (picked > 0)
+  {
+    painter.setTransform(QTransform());
+    painter.setPen(QPen(Qt::yellow));
+    painter.drawText(rect(), Qt::AlignLeft | Qt::AlignTop, QString("Picked: %1").arg(picked));
+  }
+
   if (m_fps > 0)
   {
     painter.setTransform(QTransform());
@@ -153,6 +221,25 @@ void Particules::wheelEvent(QWheelEvent* event)
   update();
 }
 
+void Particules::mousePressEvent(QMouseEvent* event)
+{
+  m_Cursor = event->position().toPoint();
+  update();
+}
+
+void Particules::mouseMoveEvent(QMouseEvent* event)
+{
+  m_Cursor = event->position().toPoint();
+  update();
+}
+
+void Particules::leaveEvent(QEvent* event)
+{
+  Q_UNUSED(event);
+  m_Cursor.reset();
+  update();
+}
+
 void Particules::resizeEvent(QResizeEvent* event)
 {
   if (event->oldSize() == QSize {-1, -1})
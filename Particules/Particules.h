@@ -3,7 +3,9 @@
 #include <QtWidgets/QWidget>
 #include "../QuadTree/TQuadTree.h"
 #include <list>
+#include <optional>
 #include <queue>
+#include <vector>
 
 class CRect
 {
@@ -29,6 +31,10 @@ class Particules : public QWidget
   Q_OBJECT
   TQuadTree<CRect> m_QuadTree;
   std::list<CRect> m_List;
+  std::vector<QPointF> m_Speeds;
+  std::vector<TQuadTree<CRect>::handle> m_Handles;
+  bool m_Animate = false;
+  const float m_Margin = 0.005f;
 #ifdef _DEBUG
   const size_t m_nbParticules = 10000;
 #else
@@ -40,9 +46,11 @@ class Particules : public QWidget
   QPointF m_translate;
   size_t m_frameTimeIndex = 0;
   size_t m_fps = 0;
+  std::optional<QPoint> m_Cursor;
 
   QPointF pixelToLogical(const QPoint& p) const;
   void computeTranslate();
+  void animate();
 
   enum class EIterAlgorithm
   {
@@ -52,7 +60,9 @@ class Particules : public QWidget
     quadTreeFindCollidingFunction,
     quadTreeIterators,
     quadTreeInscribedIterators,
-    quadTreeCollidingIterators
+    quadTreeCollidingIterators,
+    quadTreeInscribedVisitor,
+    quadTreeCollidingVisitor
   } m_IterAlgorithm;
 
 public:
@@ -62,6 +72,9 @@ public:
 protected:
   void paintEvent(QPaintEvent* event) override;
   void wheelEvent(QWheelEvent* event) override;
+  void mousePressEvent(QMouseEvent* event) override;
+  void mouseMoveEvent(QMouseEvent* event) override;
+  void leaveEvent(QEvent* event) override;
   void resizeEvent(QResizeEvent* event) override;
   void timerEvent(QTimerEvent* event) override;
 
@@ -73,5 +86,8 @@ public slots:
   void onIterAlgorithmQuadTreeIterators() { m_IterAlgorithm = EIterAlgorithm::quadTreeIterators; update(); }
   void onIterAlgorithmQuadTreeInscribedIterators() { m_IterAlgorithm = EIterAlgorithm::quadTreeInscribedIterators; update(); }
   void onIterAlgorithmQuadTreeCollidingIterators() { m_IterAlgorithm = EIterAlgorithm::quadTreeCollidingIterators; update(); }
+  void onIterAlgorithmQuadTreeInscribedVisitor() { m_IterAlgorithm = EIterAlgorithm::quadTreeInscribedVisitor; update(); }
+  void onIterAlgorithmQuadTreeCollidingVisitor() { m_IterAlgorithm = EIterAlgorithm::quadTreeCollidingVisitor; update(); }
+  void onAnimate(bool checked) { m_Animate = checked; update(); }
 
 };
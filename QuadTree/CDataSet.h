@@ -0,0 +1,504 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "CMappedFile.h"
+#include "TQuadTree.h"
+
+/**
+ * @brief Rectangle tel qu'il est enregistré dans un fichier de jeu de données : quatre float consécutifs.
+ *
+ * Le type vérifie le concept QuadTreeData : une liste d'enregistrements peut être chargée telle quelle dans un TQuadTree<SDataSetRecord>.
+ */
+struct SDataSetRecord
+{
+  float m_x1; ///< La coordonnée x du coin supérieur gauche.
+  float m_y1; ///< La coordonnée y du coin supérieur gauche.
+  float m_x2; ///< La coordonnée x du coin inférieur droit.
+  float m_y2; ///< La coordonnée y du coin inférieur droit.
+
+  bool operator==(const SDataSetRecord& other) const = default;
+
+  float x1() const { return m_x1; }
+  float y1() const { return m_y1; }
+  float x2() const { return m_x2; }
+  float y2() const { return m_y2; }
+};
+
+static_assert(sizeof(SDataSetRecord) == 4 * sizeof(float) && std::is_trivially_copyable_v<SDataSetRecord>,
+  "Un enregistrement doit avoir exactement la disposition du fichier");
+
+/**
+ * @brief Jeu de données de test projeté en mémoire.
+ *
+ * Deux formats de fichier sont reconnus, dans l'ordre des octets de la machine :
+ * - la version 1, brute : le nombre de rectangles (entier de 64 bits), les rectangles eux-mêmes (quatre float x1, y1, x2, y2 chacun),
+ *   puis la profondeur du QuadTree théorique correspondant (entier de 64 bits) ;
+ * - la version 2 (voir save) : un en-tête versionné donnant le nombre de rectangles, les limites du monde, la profondeur et
+ *   la répartition des rectangles, puis les rectangles découpés en tranches de taille fixe, puis la somme de contrôle de chaque tranche.
+ *
+ * Plutôt que de lire le fichier rectangle par rectangle, il est projeté en mémoire et ses enregistrements sont exposés
+ * directement sous forme de std::span : ils ne sont ni copiés ni convertis, et le système lit le fichier par grands blocs
+ * au fil des accès. Les enregistrements peuvent être parcourus par tranches (forEachChunk, chunk) ou chargés d'un seul coup
+ * dans un TQuadTree (voir as) par son chargement en bloc.
+ *
+ * En version 2, les métadonnées sont lues dans l'en-tête sans parcourir les rectangles, et chaque tranche peut être vérifiée
+ * indépendamment des autres (checkChunk), par exemple en parallèle. En version 1, elles sont calculées par un parcours
+ * du fichier au premier appel de limits ou distribution, pas à l'ouverture : ouvrir un fichier ne lit que son en-tête,
+ * quelle que soit sa version. Les limites du monde sont alors celles des rectangles et les tranches ne sont pas vérifiables.
+ *
+ * Si le fichier ne peut pas être projeté ou si sa taille ne correspond pas à son contenu, une exception de type std::runtime_error est levée.
+ */
+class CDataSet
+{
+public:
+  /**
+   * @brief Répartition des rectangles d'un jeu de données.
+   */
+  struct SDistribution
+  {
+    SLimits extent;   ///< Limites de tous les rectangles, NaN pour un jeu de données vide
+    float meanWidth;  ///< Largeur moyenne d'un rectangle
+    float meanHeight; ///< Hauteur moyenne d'un rectangle
+    float maxWidth;   ///< Largeur maximale d'un rectangle
+    float maxHeight;  ///< Hauteur maximale d'un rectangle
+  };
+
+  static constexpr size_t defaultChunkSize = 65536; ///< Nombre d'enregistrements d'une tranche par défaut (1 Mio)
+
+private:
+  /**
+   * @brief En-tête d'un fichier de jeu de données en version 2.
+   *
+   * Les positions des sections sont relatives au début du fichier. La somme de contrôle de l'en-tête est calculée
+   * avec headerChecksum à 0, et couvre aussi la table des sommes de contrôle des tranches.
+   */
+  struct SFileHeader
+  {
+    char magic[8];             ///< Signature du format
+    uint32_t version;          ///< Version du format
+    uint32_t byteOrder;        ///< fileByteOrder écrit dans l'ordre des octets de la machine qui a écrit le fichier
+    uint32_t recordSize;       ///< Taille d'un enregistrement
+    uint32_t reserved;         ///< Réservé, à 0
+    uint64_t count;            ///< Nombre de rectangles
+    uint64_t depth;            ///< Profondeur maximale du QuadTree théorique
+    uint64_t chunkSize;        ///< Nombre d'enregistrements d'une tranche, la dernière pouvant être plus courte
+    uint64_t chunkCount;       ///< Nombre de tranches
+    uint64_t recordsOffset;    ///< Position des enregistrements, multiple de la taille d'une ligne de cache
+    uint64_t checksumsOffset;  ///< Position de la table des sommes de contrôle des tranches
+    float limits[4];           ///< Limites du monde
+    float extent[4];           ///< Limites de tous les rectangles
+    float meanSize[2];         ///< Largeur et hauteur moyennes
+    float maxSize[2];          ///< Largeur et hauteur maximales
+    uint64_t headerChecksum;   ///< Somme de contrôle de l'en-tête et de la table des sommes de contrôle
+  };
+
+  static_assert(sizeof(SFileHeader) % 64 == 0, "Les enregistrements suivent l'en-tête sur une ligne de cache");
+
+  static constexpr char fileMagic[8] = { 'T', 'Q', 'T', 'D', 'A', 'T', 'A', 'S' }; ///< Signature du format de fichier
+  static constexpr uint32_t fileVersion = 2;            ///< Version du format de fichier
+  static constexpr uint32_t fileByteOrder = 0x01020304; ///< Valeur témoin de l'ordre des octets
+
+  std::shared_ptr<const CMappedFile> m_pFile; ///< Le fichier projeté, partagé par les copies
+  std::span<const SDataSetRecord> m_Records;  ///< Les enregistrements, dans le fichier projeté
+  std::span<const uint64_t> m_Checksums;      ///< Les sommes de contrôle des tranches, vide en version 1
+  size_t m_Version = 1;                       ///< La version du format du fichier
+  size_t m_Depth = 0;                         ///< La profondeur du QuadTree théorique
+  size_t m_ChunkSize = defaultChunkSize;      ///< Le nombre d'enregistrements d'une tranche
+  SLimits m_Limits{};                         ///< Les limites du monde, en version 2
+  mutable std::optional<SDistribution> m_Distribution; ///< La répartition des rectangles, calculée au premier appel en version 1
+
+  /**
+   * @brief Lit un entier de 64 bits à une position quelconque du fichier.
+   */
+  static uint64_t readCount(const unsigned char* pData)
+  {
+    uint64_t value;
+    std::memcpy(&value, pData, sizeof(value));
+    return value;
+  }
+
+  /**
+   * @brief Calcule la somme de contrôle d'une zone mémoire dont la taille est un multiple de 4 octets.
+   *
+   * C'est une somme de Fletcher sur des mots de 32 bits : la somme des mots et la somme des mots pondérés par leur position,
+   * toutes deux modulo 2^64. Elle détecte les erreurs sur un mot et les permutations de mots, et se vectorise.
+   */
+  static uint64_t checksum(const void* pData, size_t size)
+  {
+    const unsigned char* pBytes = static_cast<const unsigned char*>(pData);
+    const size_t count = size / sizeof(uint32_t);
+    uint64_t sum = 0, weighted = 0;
+    for (size_t index = 0; index < count; ++index)
+    {
+      uint32_t word;
+      std::memcpy(&word, pBytes + index * sizeof(word), sizeof(word));
+      sum += word;
+      weighted += (index + 1) * static_cast<uint64_t>(word);
+    }
+    return sum ^ std::rotl(weighted, 32) ^ count;
+  }
+
+  /**
+   * @brief Calcule la répartition d'une liste d'enregistrements.
+   */
+  static SDistribution distributionOf(std::span<const SDataSetRecord> records)
+  {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    SDistribution distribution = { { nan, nan, nan, nan }, 0.0f, 0.0f, 0.0f, 0.0f };
+    if (records.empty())
+      return distribution;
+    SLimits extent = { records[0].m_x1, records[0].m_y1, records[0].m_x2, records[0].m_y2 };
+    double width = 0.0, height = 0.0;
+    for (const SDataSetRecord& record : records)
+    {
+      extent = { std::min(extent.x1, record.m_x1), std::min(extent.y1, record.m_y1),
+                 std::max(extent.x2, record.m_x2), std::max(extent.y2, record.m_y2) };
+      width += record.m_x2 - record.m_x1;
+      height += record.m_y2 - record.m_y1;
+      distribution.maxWidth = std::max(distribution.maxWidth, record.m_x2 - record.m_x1);
+      distribution.maxHeight = std::max(distribution.maxHeight, record.m_y2 - record.m_y1);
+    }
+    distribution.extent = extent;
+    distribution.meanWidth = static_cast<float>(width / records.size());
+    distribution.meanHeight = static_cast<float>(height / records.size());
+    return distribution;
+  }
+
+  /**
+   * @brief Ouvre un fichier en version 1.
+   */
+  void openRaw(const std::filesystem::path& path)
+  {
+    const size_t fileSize = m_pFile->size();
+    if (fileSize < 2 * sizeof(uint64_t))
+      throw std::runtime_error("CDataSet : le fichier est trop court " + path.string());
+    const uint64_t count = readCount(m_pFile->data());
+    if (count > (fileSize - 2 * sizeof(uint64_t)) / sizeof(SDataSetRecord)
+      || fileSize != 2 * sizeof(uint64_t) + count * sizeof(SDataSetRecord))
+      throw std::runtime_error("CDataSet : le fichier est tronqué ou corrompu " + path.string());
+    //Les enregistrements suivent un entier de 64 bits dans une projection alignée sur une page : ils sont alignés
+    m_Records = { reinterpret_cast<const SDataSetRecord*>(m_pFile->data() + sizeof(uint64_t)), static_cast<size_t>(count) };
+    m_Depth = static_cast<size_t>(readCount(m_pFile->data() + fileSize - sizeof(uint64_t)));
+  }
+
+  /**
+   * @brief Ouvre un fichier en version 2 : l'en-tête et la table des sommes de contrôle sont vérifiés, pas les tranches.
+   */
+  void open(const std::filesystem::path& path)
+  {
+    const uint64_t size = m_pFile->size();
+    SFileHeader header;
+    if (size < sizeof(header))
+      throw std::runtime_error("CDataSet : le fichier est trop court " + path.string());
+    std::memcpy(&header, m_pFile->data(), sizeof(header));
+    if (header.version != fileVersion)
+      throw std::runtime_error("CDataSet : version de fichier inconnue " + path.string());
+    if (header.byteOrder != fileByteOrder || header.recordSize != sizeof(SDataSetRecord))
+      throw std::runtime_error("CDataSet : le fichier a été écrit pour une autre machine " + path.string());
+
+    //Chaque section doit tenir dans le fichier, à une position alignée, avant de pouvoir vérifier la somme de contrôle
+    const bool valid = header.chunkSize > 0
+      && header.chunkCount == header.count / header.chunkSize + (header.count % header.chunkSize != 0)
+      && header.recordsOffset % alignof(SDataSetRecord) == 0 && header.recordsOffset >= sizeof(header) && header.recordsOffset <= size
+      && header.count <= (size - header.recordsOffset) / sizeof(SDataSetRecord)
+      && header.checksumsOffset % alignof(uint64_t) == 0 && header.checksumsOffset >= header.recordsOffset + header.count * sizeof(SDataSetRecord)
+      && header.checksumsOffset <= size && header.chunkCount == (size - header.checksumsOffset) / sizeof(uint64_t)
+      && (size - header.checksumsOffset) % sizeof(uint64_t) == 0;
+    if (!valid)
+      throw std::runtime_error("CDataSet : le fichier est tronqué ou corrompu " + path.string());
+    const uint64_t expected = std::exchange(header.headerChecksum, 0);
+    const size_t tableSize = static_cast<size_t>(header.chunkCount * sizeof(uint64_t));
+    if ((checksum(&header, sizeof(header)) ^ checksum(m_pFile->data() + header.checksumsOffset, tableSize)) != expected)
+      throw std::runtime_error("CDataSet : l'en-tête du fichier est corrompu " + path.string());
+
+    m_Version = header.version;
+    m_Records = { reinterpret_cast<const SDataSetRecord*>(m_pFile->data() + header.recordsOffset), static_cast<size_t>(header.count) };
+    m_Checksums = { reinterpret_cast<const uint64_t*>(m_pFile->data() + header.checksumsOffset), static_cast<size_t>(header.chunkCount) };
+    m_Depth = static_cast<size_t>(header.depth);
+    m_ChunkSize = static_cast<size_t>(header.chunkSize);
+    m_Limits = { header.limits[0], header.limits[1], header.limits[2], header.limits[3] };
+    m_Distribution = { { header.extent[0], header.extent[1], header.extent[2], header.extent[3] },
+                       header.meanSize[0], header.meanSize[1], header.maxSize[0], header.maxSize[1] };
+  }
+
+public:
+  /**
+   * @brief Constructeur de la classe CDataSet. Le format du fichier est reconnu à sa signature.
+   *
+   * @param path Le chemin du fichier de jeu de données.
+   */
+  explicit CDataSet(const std::filesystem::path& path)
+    : m_pFile(std::make_shared<const CMappedFile>(path))
+  {
+    if (m_pFile->size() >= sizeof(fileMagic) && std::memcmp(m_pFile->data(), fileMagic, sizeof(fileMagic)) == 0)
+      open(path);
+    else
+      openRaw(path);
+  }
+
+  /**
+   * @brief Enregistre un jeu de données dans un fichier en version 2.
+   *
+   * Le fichier contient un en-tête, les enregistrements à partir d'une position multiple de la taille d'une ligne de cache,
+   * puis la table des sommes de contrôle des tranches. Les éléments sont lus en une seule passe et écrits tranche par tranche.
+   * Si le fichier ne peut pas être écrit, une exception de type std::runtime_error est levée.
+   *
+   * @param path Le chemin du fichier, remplacé s'il existe.
+   * @param items Les rectangles à enregistrer, de n'importe quel type vérifiant le concept QuadTreeData.
+   * @param limits Les limites du monde.
+   * @param depth La profondeur maximale du QuadTree théorique correspondant.
+   * @param chunkSize Le nombre d'enregistrements d'une tranche.
+   */
+  template <std::ranges::input_range R>
+    requires QuadTreeData<std::remove_cvref_t<std::ranges::range_reference_t<R>>>
+  static void save(const std::filesystem::path& path, R&& items, const SLimits& limits, size_t depth, size_t chunkSize = defaultChunkSize)
+  {
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+      throw std::runtime_error("CDataSet::save : impossible de créer le fichier " + path.string());
+    SFileHeader header{};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    //Chaque tranche est écrite dès qu'elle est pleine ; la répartition se cumule tranche par tranche
+    std::vector<SDataSetRecord> chunk;
+    chunk.reserve(chunkSize);
+    std::vector<uint64_t> checksums;
+    std::vector<SDistribution> distributions;
+    uint64_t count = 0;
+    auto flush = [&]() {
+      file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size() * sizeof(SDataSetRecord)));
+      checksums.push_back(checksum(chunk.data(), chunk.size() * sizeof(SDataSetRecord)));
+      distributions.push_back(distributionOf(chunk));
+      count += chunk.size();
+      chunk.clear();
+      };
+    for (auto&& item : items)
+    {
+      chunk.push_back({ static_cast<float>(item.x1()), static_cast<float>(item.y1()),
+                        static_cast<float>(item.x2()), static_cast<float>(item.y2()) });
+      if (chunk.size() == chunkSize)
+        flush();
+    }
+    if (!chunk.empty())
+      flush();
+    file.write(reinterpret_cast<const char*>(checksums.data()), static_cast<std::streamsize>(checksums.size() * sizeof(uint64_t)));
+
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = fileVersion;
+    header.byteOrder = fileByteOrder;
+    header.recordSize = sizeof(SDataSetRecord);
+    header.count = count;
+    header.depth = depth;
+    header.chunkSize = chunkSize;
+    header.chunkCount = checksums.size();
+    header.recordsOffset = sizeof(header);
+    header.checksumsOffset = sizeof(header) + count * sizeof(SDataSetRecord);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float world[4] = { limits.x1, limits.y1, limits.x2, limits.y2 };
+    float extent[4] = { nan, nan, nan, nan };
+    double width = 0.0, height = 0.0;
+    for (size_t index = 0; index < distributions.size(); ++index)
+    {
+      const SDistribution& distribution = distributions[index];
+      const SLimits& bounds = distribution.extent;
+      extent[0] = index == 0 ? bounds.x1 : std::min(extent[0], bounds.x1);
+      extent[1] = index == 0 ? bounds.y1 : std::min(extent[1], bounds.y1);
+      extent[2] = index == 0 ? bounds.x2 : std::max(extent[2], bounds.x2);
+      extent[3] = index == 0 ? bounds.y2 : std::max(extent[3], bounds.y2);
+      const double records = static_cast<double>(std::min<uint64_t>(chunkSize, count - index * chunkSize));
+      width += distribution.meanWidth * records;
+      height += distribution.meanHeight * records;
+      header.maxSize[0] = std::max(header.maxSize[0], distribution.maxWidth);
+      header.maxSize[1] = std::max(header.maxSize[1], distribution.maxHeight);
+    }
+    std::copy(std::begin(world), std::end(world), header.limits);
+    std::copy(std::begin(extent), std::end(extent), header.extent);
+    header.meanSize[0] = count == 0 ? 0.0f : static_cast<float>(width / count);
+    header.meanSize[1] = count == 0 ? 0.0f : static_cast<float>(height / count);
+    header.headerChecksum = checksum(&header, sizeof(header)) ^ checksum(checksums.data(), checksums.size() * sizeof(uint64_t));
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file)
+      throw std::runtime_error("CDataSet::save : erreur d'écriture du fichier " + path.string());
+  }
+
+  /**
+   * @brief Retourne la version du format du fichier.
+   */
+  size_t version() const
+  {
+    return m_Version;
+  }
+
+  /**
+   * @brief Retourne le nombre de rectangles du jeu de données.
+   */
+  size_t size() const
+  {
+    return m_Records.size();
+  }
+
+  /**
+   * @brief Vérifie si le jeu de données est vide.
+   */
+  bool empty() const
+  {
+    return m_Records.empty();
+  }
+
+  /**
+   * @brief Retourne la profondeur maximale du QuadTree théorique correspondant au jeu de données.
+   */
+  size_t depth() const
+  {
+    return m_Depth;
+  }
+
+  /**
+   * @brief Retourne les limites du monde : celles enregistrées en version 2, celles des rectangles en version 1 (voir distribution).
+   */
+  const SLimits& limits() const
+  {
+    return m_Version == 1 ? distribution().extent : m_Limits;
+  }
+
+  /**
+   * @brief Retourne la répartition des rectangles.
+   *
+   * En version 1, elle est calculée au premier appel par un parcours de tous les rectangles, puis conservée.
+   * Comme pour TQuadTree::depth, ce premier appel ne doit pas être concurrent d'un autre appel sur le même objet.
+   */
+  const SDistribution& distribution() const
+  {
+    if (!m_Distribution)
+      m_Distribution = distributionOf(m_Records);
+    return *m_Distribution;
+  }
+
+  /**
+   * @brief Retourne tous les enregistrements, sans copie. Ils restent valides tant qu'une copie du jeu de données existe.
+   */
+  std::span<const SDataSetRecord> records() const
+  {
+    return m_Records;
+  }
+
+  /**
+   * @brief Retourne le nombre d'enregistrements d'une tranche du fichier.
+   */
+  size_t chunkSize() const
+  {
+    return m_ChunkSize;
+  }
+
+  /**
+   * @brief Retourne le nombre de tranches du fichier.
+   */
+  size_t chunkCount() const
+  {
+    return (m_Records.size() + m_ChunkSize - 1) / m_ChunkSize;
+  }
+
+  /**
+   * @brief Retourne les enregistrements d'une tranche du fichier, sans parcourir les précédentes.
+   *
+   * @param index L'index de la tranche, inférieur à chunkCount().
+   */
+  std::span<const SDataSetRecord> chunk(size_t index) const
+  {
+    const size_t first = index * m_ChunkSize;
+    return m_Records.subspan(first, std::min(m_ChunkSize, m_Records.size() - first));
+  }
+
+  /**
+   * @brief Vérifie la somme de contrôle d'une tranche du fichier. Toujours vrai en version 1.
+   *
+   * Les tranches sont indépendantes : plusieurs threads peuvent en vérifier en même temps.
+   *
+   * @param index L'index de la tranche, inférieur à chunkCount().
+   * @return true si le contenu de la tranche est celui qui a été enregistré.
+   */
+  bool checkChunk(size_t index) const
+  {
+    if (m_Checksums.empty())
+      return true;
+    const std::span<const SDataSetRecord> records = chunk(index);
+    return checksum(records.data(), records.size_bytes()) == m_Checksums[index];
+  }
+
+  /**
+   * @brief Vérifie toutes les tranches du fichier (voir checkChunk).
+   *
+   * @return true si le contenu de toutes les tranches est celui qui a été enregistré.
+   */
+  bool verify() const
+  {
+    for (size_t index = 0; index < chunkCount(); ++index)
+      if (!checkChunk(index))
+        return false;
+    return true;
+  }
+
+  /**
+   * @brief Appelle une fonction sur les tranches du fichier, dans l'ordre.
+   *
+   * @param f La fonction appelée avec chaque tranche, de type std::span<const SDataSetRecord>.
+   */
+  template <typename F>
+  void forEachChunk(F&& f) const
+  {
+    forEachChunk(m_ChunkSize, std::forward<F>(f));
+  }
+
+  /**
+   * @brief Appelle une fonction sur des tranches consécutives d'enregistrements.
+   *
+   * Une tranche de quelques milliers d'enregistrements tient dans le cache : elle peut être traitée en plusieurs passes
+   * sans relire la mémoire.
+   *
+   * @param chunkSize Le nombre d'enregistrements de chaque tranche, la dernière pouvant être plus courte.
+   * @param f La fonction appelée avec chaque tranche, de type std::span<const SDataSetRecord>.
+   */
+  template <typename F>
+  void forEachChunk(size_t chunkSize, F&& f) const
+  {
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    for (size_t first = 0; first < m_Records.size(); first += chunkSize)
+      f(m_Records.subspan(first, std::min(chunkSize, m_Records.size() - first)));
+  }
+
+  /**
+   * @brief Retourne les enregistrements convertis à la volée en éléments de type T, construits à partir de (x1, y1, x2, y2).
+   *
+   * La vue est indexable et connaît sa taille : passée à TQuadTree::assign ou au constructeur de TQuadTree,
+   * elle alimente directement le chargement en bloc, sans liste intermédiaire.
+   *
+   * @tparam T Le type des éléments.
+   */
+  template <typename T>
+    requires std::constructible_from<T, float, float, float, float>
+  auto as() const
+  {
+    return m_Records | std::views::transform([](const SDataSetRecord& record) {
+      return T(record.m_x1, record.m_y1, record.m_x2, record.m_y2);
+      });
+  }
+};
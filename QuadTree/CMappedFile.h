@@ -0,0 +1,124 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Fichier projeté en mémoire, en lecture seule.
+ *
+ * Le contenu du fichier est lu à la demande par le système, page par page, et les pages sont partagées
+ * entre tous les processus qui projettent le même fichier.
+ */
+class CMappedFile
+{
+  const unsigned char* m_pData = nullptr; ///< Le contenu du fichier, nullptr pour un fichier vide
+  size_t m_Size = 0;                      ///< La taille du fichier, en octets
+
+public:
+  /**
+   * @brief Constructeur de la classe CMappedFile.
+   *
+   * Si le fichier ne peut pas être ouvert ou projeté, une exception de type std::runtime_error est levée.
+   *
+   * @param path Le chemin du fichier.
+   */
+  explicit CMappedFile(const std::filesystem::path& path)
+  {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      throw std::runtime_error("CMappedFile : impossible d'ouvrir le fichier " + path.string());
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+      CloseHandle(file);
+      throw std::runtime_error("CMappedFile : impossible de lire la taille du fichier " + path.string());
+    }
+    m_Size = static_cast<size_t>(size.QuadPart);
+    if (m_Size == 0)
+    {
+      CloseHandle(file);
+      return;
+    }
+    //La projection garde le fichier ouvert : les handles peuvent être fermés
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+      throw std::runtime_error("CMappedFile : impossible de projeter le fichier " + path.string());
+    m_pData = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (m_pData == nullptr)
+      throw std::runtime_error("CMappedFile : impossible de projeter le fichier " + path.string());
+#else
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+      throw std::runtime_error("CMappedFile : impossible d'ouvrir le fichier " + path.string());
+    struct stat status;
+    if (::fstat(file, &status) != 0)
+    {
+      ::close(file);
+      throw std::runtime_error("CMappedFile : impossible de lire la taille du fichier " + path.string());
+    }
+    m_Size = static_cast<size_t>(status.st_size);
+    if (m_Size == 0)
+    {
+      ::close(file);
+      return;
+    }
+    //La projection garde le fichier ouvert : le descripteur peut être fermé
+    void* pData = ::mmap(nullptr, m_Size, PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+    if (pData == MAP_FAILED)
+      throw std::runtime_error("CMappedFile : impossible de projeter le fichier " + path.string());
+    m_pData = static_cast<const unsigned char*>(pData);
+#endif
+  }
+
+  CMappedFile(const CMappedFile&) = delete;
+  CMappedFile& operator=(const CMappedFile&) = delete;
+
+  /**
+   * @brief Destructeur de la classe CMappedFile : la projection est supprimée.
+   */
+  ~CMappedFile()
+  {
+    if (m_pData == nullptr)
+      return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_pData);
+#else
+    ::munmap(const_cast<unsigned char*>(m_pData), m_Size);
+#endif
+  }
+
+  /**
+   * @brief Retourne le contenu du fichier, aligné sur une page.
+   */
+  const unsigned char* data() const
+  {
+    return m_pData;
+  }
+
+  /**
+   * @brief Retourne la taille du fichier, en octets.
+   */
+  size_t size() const
+  {
+    return m_Size;
+  }
+};
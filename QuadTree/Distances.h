@@ -0,0 +1,49 @@
+#pragma once
+#include <algorithm>
+
+/**
+ * @brief Distance d'un point à un élément : le carré de la distance du point au rectangle de l'élément, nulle à l'intérieur.
+ *
+ * Une distance utilisable par TQuadTree::findNearest fournit deux fonctions, pour des limites de n'importe quel type de coordonnées :
+ * - operator()(bounds, x, y) : la distance du point (x, y) à un élément de limites bounds ;
+ * - bound(cell, x, y) : un minorant de la distance du point à tout élément inclus dans la zone cell, pour écarter les noeuds éloignés.
+ * Les deux fonctions doivent être croissantes avec la distance réelle : leur carré suffit, sans racine carrée.
+ */
+struct SBoxDistance
+{
+  template <typename Limits, typename Coordinate>
+  Coordinate operator()(const Limits& bounds, Coordinate x, Coordinate y) const
+  {
+    const Coordinate dx = std::max({ bounds.x1 - x, x - bounds.x2, Coordinate(0) });
+    const Coordinate dy = std::max({ bounds.y1 - y, y - bounds.y2, Coordinate(0) });
+    return dx * dx + dy * dy;
+  }
+
+  template <typename Limits, typename Coordinate>
+  Coordinate bound(const Limits& cell, Coordinate x, Coordinate y) const
+  {
+    return (*this)(cell, x, y);
+  }
+};
+
+/**
+ * @brief Distance d'un point au centre du rectangle d'un élément, au carré (voir SBoxDistance).
+ *
+ * Le centre d'un élément inclus dans une zone étant dans cette zone, la distance du point à la zone est un minorant.
+ */
+struct SCentroidDistance
+{
+  template <typename Limits, typename Coordinate>
+  Coordinate operator()(const Limits& bounds, Coordinate x, Coordinate y) const
+  {
+    const Coordinate dx = (bounds.x1 + bounds.x2) / 2 - x;
+    const Coordinate dy = (bounds.y1 + bounds.y2) / 2 - y;
+    return dx * dx + dy * dy;
+  }
+
+  template <typename Limits, typename Coordinate>
+  Coordinate bound(const Limits& cell, Coordinate x, Coordinate y) const
+  {
+    return SBoxDistance()(cell, x, y);
+  }
+};
@@ -0,0 +1,252 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+#include "Distances.h"
+#include "TLimits.h"
+
+/**
+ * @brief Concept définissant une forme de requête : les zones acceptées par les surcharges de findColliding, findInscribed, etc.
+ *
+ * Une forme fournit :
+ * - x1(), y1(), x2() et y2() : son rectangle englobant, qui limite le parcours aux noeuds qui le touchent ;
+ * - intersects(limits) : vrai si la forme touche la zone rectangulaire limits (bords inclus) ;
+ * - contains(limits) : vrai si la zone rectangulaire limits est totalement incluse dans la forme (bords inclus).
+ * Les deux tests doivent être exacts : ils servent à la fois à tester les éléments et à écarter ou retenir d'un bloc
+ * les noeuds, par leur cellule agrandie.
+ *
+ * @tparam S Le type de la forme.
+ * @tparam Limits Le type des limites des zones testées.
+ */
+template <typename S, typename Limits>
+concept QueryShape = requires(const S& s, const Limits& limits)
+{
+  { s.x1() } -> std::convertible_to<float>;
+  { s.y1() } -> std::convertible_to<float>;
+  { s.x2() } -> std::convertible_to<float>;
+  { s.y2() } -> std::convertible_to<float>;
+  { s.intersects(limits) } -> std::convertible_to<bool>;
+  { s.contains(limits) } -> std::convertible_to<bool>;
+};
+
+/**
+ * @brief Disque de requête, défini par son centre et son rayon (voir QueryShape).
+ *
+ * @tparam Coordinate Le type des coordonnées, celui du QuadTree interrogé (voir TQuadTree::circle_type).
+ */
+template <typename Coordinate = float>
+class TCircle
+{
+  Coordinate m_X;      ///< La coordonnée x du centre
+  Coordinate m_Y;      ///< La coordonnée y du centre
+  Coordinate m_Radius; ///< Le rayon
+
+public:
+  /**
+   * @brief Constructeur de la classe TCircle.
+   *
+   * Un rayon nul donne un point. Si le rayon est négatif ou NaN, ou si le centre a des coordonnées NaN,
+   * une exception de type std::invalid_argument est levée : le rectangle englobant serait retourné
+   * et les requêtes se contrediraient.
+   *
+   * @param x La coordonnée x du centre.
+   * @param y La coordonnée y du centre.
+   * @param radius Le rayon.
+   */
+  TCircle(Coordinate x, Coordinate y, Coordinate radius)
+    : m_X(x), m_Y(y), m_Radius(radius)
+  {
+    if (!(radius >= 0))
+      throw std::invalid_argument("TCircle : le rayon doit être positif ou nul");
+    if (std::isnan(x) || std::isnan(y))
+      throw std::invalid_argument("TCircle : les coordonnées du centre ne doivent pas être NaN");
+  }
+
+  Coordinate x() const { return m_X; }
+  Coordinate y() const { return m_Y; }
+  Coordinate radius() const { return m_Radius; }
+
+  Coordinate x1() const { return m_X - m_Radius; }
+  Coordinate y1() const { return m_Y - m_Radius; }
+  Coordinate x2() const { return m_X + m_Radius; }
+  Coordinate y2() const { return m_Y + m_Radius; }
+
+  /**
+   * @brief Vérifie si le disque touche une zone : le point de la zone le plus proche du centre est dans le disque.
+   */
+  template <typename Limits>
+  bool intersects(const Limits& limits) const
+  {
+    return SBoxDistance()(limits, m_X, m_Y) <= m_Radius * m_Radius;
+  }
+
+  /**
+   * @brief Vérifie si une zone est incluse dans le disque : le coin de la zone le plus éloigné du centre est dans le disque.
+   */
+  template <typename Limits>
+  bool contains(const Limits& limits) const
+  {
+    const Coordinate dx = std::max(m_X - limits.x1, limits.x2 - m_X);
+    const Coordinate dy = std::max(m_Y - limits.y1, limits.y2 - m_Y);
+    return dx * dx + dy * dy <= m_Radius * m_Radius;
+  }
+};
+
+/**
+ * @brief Polygone convexe de requête, par exemple une vue tournée ou l'empreinte d'un capteur (voir QueryShape).
+ *
+ * Chaque côté est conservé sous la forme d'un demi-plan a.x + b.y <= c contenant le polygone. Une zone rectangulaire
+ * touche le polygone si elle touche son rectangle englobant et n'est entièrement hors d'aucun demi-plan (théorème
+ * de l'axe séparateur) ; elle est incluse dans le polygone si ses quatre coins le sont. Pour chaque demi-plan,
+ * seul le coin de la zone qui minimise (ou maximise) a.x + b.y est testé : le coût est d'un produit par côté.
+ *
+ * @tparam Coordinate Le type des coordonnées, celui du QuadTree interrogé (voir TQuadTree::polygon_type).
+ */
+template <typename Coordinate = float>
+class TConvexPolygon
+{
+public:
+  /**
+   * @brief Sommet du polygone.
+   */
+  struct SPoint
+  {
+    Coordinate x; ///< La coordonnée x du sommet.
+    Coordinate y; ///< La coordonnée y du sommet.
+
+    bool operator==(const SPoint& other) const = default;
+  };
+
+private:
+  /**
+   * @brief Demi-plan a.x + b.y <= c portant un côté du polygone.
+   */
+  struct SEdge
+  {
+    Coordinate a;
+    Coordinate b;
+    Coordinate c;
+  };
+
+  std::vector<SPoint> m_Vertices; ///< Les sommets, dans l'ordre donné au constructeur
+  std::vector<SEdge> m_Edges;     ///< Les demi-plans des côtés, orientés vers l'intérieur
+  TLimits<Coordinate> m_Bounds;   ///< Le rectangle englobant
+
+public:
+  /**
+   * @brief Constructeur de la classe TConvexPolygon.
+   *
+   * Les sommets peuvent être donnés dans un sens ou dans l'autre. Si le polygone a moins de trois sommets, n'est pas convexe
+   * (y compris un contour qui se croise, comme une étoile),
+   * est d'aire nulle ou a des coordonnées non finies, une exception de type std::invalid_argument est levée.
+   *
+   * @param vertices Les sommets, dans l'ordre du contour.
+   */
+  TConvexPolygon(std::vector<SPoint> vertices)
+    : m_Vertices(std::move(vertices))
+  {
+    if (m_Vertices.size() < 3)
+      throw std::invalid_argument("TConvexPolygon : un polygone a au moins trois sommets");
+    const size_t count = m_Vertices.size();
+    //Convexe : tous les virages sont du même côté (les sommets alignés sont tolérés), et le contour ne fait qu'un tour.
+    //Une étoile comme le pentagramme tourne toujours du même côté, mais en faisant deux tours.
+    Coordinate orientation = 0;
+    Coordinate turning = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      const SPoint& p = m_Vertices[i];
+      const SPoint& q = m_Vertices[(i + 1) % count];
+      const SPoint& r = m_Vertices[(i + 2) % count];
+      if (!std::isfinite(p.x) || !std::isfinite(p.y))
+        throw std::invalid_argument("TConvexPolygon : les coordonnées des sommets doivent être finies");
+      const Coordinate cross = (q.x - p.x) * (r.y - q.y) - (q.y - p.y) * (r.x - q.x);
+      const Coordinate dot = (q.x - p.x) * (r.x - q.x) + (q.y - p.y) * (r.y - q.y);
+      if (cross * orientation < 0)
+        throw std::invalid_argument("TConvexPolygon : le polygone n'est pas convexe");
+      if (cross != 0)
+        orientation = cross;
+      turning += std::atan2(cross, dot);
+    }
+    if (orientation == 0)
+      throw std::invalid_argument("TConvexPolygon : le polygone est d'aire nulle");
+    //La somme des angles extérieurs vaut un tour, au signe près, aux erreurs d'arrondi près
+    if (std::abs(std::abs(turning) - 2 * std::numbers::pi_v<Coordinate>) > std::numbers::pi_v<Coordinate>)
+      throw std::invalid_argument("TConvexPolygon : le polygone n'est pas convexe");
+
+    m_Bounds = { m_Vertices[0].x, m_Vertices[0].y, m_Vertices[0].x, m_Vertices[0].y };
+    m_Edges.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      const SPoint& p = m_Vertices[i];
+      const SPoint& q = m_Vertices[(i + 1) % count];
+      m_Bounds = { std::min(m_Bounds.x1, p.x), std::min(m_Bounds.y1, p.y), std::max(m_Bounds.x2, p.x), std::max(m_Bounds.y2, p.y) };
+      //La normale (q - p) tournée d'un quart de tour vers l'extérieur, selon le sens de parcours
+      const Coordinate a = orientation > 0 ? q.y - p.y : p.y - q.y;
+      const Coordinate b = orientation > 0 ? p.x - q.x : q.x - p.x;
+      if (a != 0 || b != 0)
+        m_Edges.push_back({ a, b, std::max(a * p.x + b * p.y, a * q.x + b * q.y) });
+    }
+  }
+
+  /**
+   * @brief Construit un rectangle tourné, par exemple la vue d'une caméra tournée.
+   *
+   * @param x La coordonnée x du centre.
+   * @param y La coordonnée y du centre.
+   * @param width La largeur avant rotation.
+   * @param height La hauteur avant rotation.
+   * @param angle L'angle de rotation, en radians.
+   * @return Le rectangle, sous forme de polygone convexe.
+   */
+  static TConvexPolygon rotatedRectangle(Coordinate x, Coordinate y, Coordinate width, Coordinate height, Coordinate angle)
+  {
+    const Coordinate cos = std::cos(angle);
+    const Coordinate sin = std::sin(angle);
+    const Coordinate hx = width / 2;
+    const Coordinate hy = height / 2;
+    auto corner = [&](Coordinate u, Coordinate v) { return SPoint{ x + u * cos - v * sin, y + u * sin + v * cos }; };
+    return TConvexPolygon({ corner(-hx, -hy), corner(hx, -hy), corner(hx, hy), corner(-hx, hy) });
+  }
+
+  /**
+   * @brief Retourne les sommets du polygone, dans l'ordre donné au constructeur.
+   */
+  const std::vector<SPoint>& vertices() const
+  {
+    return m_Vertices;
+  }
+
+  Coordinate x1() const { return m_Bounds.x1; }
+  Coordinate y1() const { return m_Bounds.y1; }
+  Coordinate x2() const { return m_Bounds.x2; }
+  Coordinate y2() const { return m_Bounds.y2; }
+
+  /**
+   * @brief Vérifie si le polygone touche une zone (bords inclus).
+   */
+  template <typename Limits>
+  bool intersects(const Limits& limits) const
+  {
+    if (limits.x1 > m_Bounds.x2 || limits.x2 < m_Bounds.x1 || limits.y1 > m_Bounds.y2 || limits.y2 < m_Bounds.y1)
+      return false;
+    for (const SEdge& edge : m_Edges)
+      if (edge.a * (edge.a >= 0 ? limits.x1 : limits.x2) + edge.b * (edge.b >= 0 ? limits.y1 : limits.y2) > edge.c)
+        return false;
+    return true;
+  }
+
+  /**
+   * @brief Vérifie si une zone est totalement incluse dans le polygone (bords inclus).
+   */
+  template <typename Limits>
+  bool contains(const Limits& limits) const
+  {
+    for (const SEdge& edge : m_Edges)
+      if (edge.a * (edge.a >= 0 ? limits.x2 : limits.x1) + edge.b * (edge.b >= 0 ? limits.y2 : limits.y1) > edge.c)
+        return false;
+    return true;
+  }
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+
+/**
+ * @brief Politique de subdivision par défaut d'un TQuadTree.
+ *
+ * Pour la modifier, il suffit de dériver de cette structure et de redéfinir les constantes voulues :
+ * @code
+ * struct SMyPolicy : SQuadTreePolicy
+ * {
+ *   static constexpr size_t bucketCapacity = 16;
+ *   static constexpr size_t maxDepth = 12;
+ * };
+ * using MyQuadTree = TQuadTree<Rectangle, SMyPolicy>;
+ * @endcode
+ */
+struct SQuadTreePolicy
+{
+  /**
+   * @brief Nombre d'éléments qu'une feuille conserve avant d'être subdivisée.
+   *
+   * Avec 0, un noeud est subdivisé dès qu'un élément tient dans l'un de ses enfants.
+   * Sinon, une feuille n'est subdivisée que lorsqu'elle déborde : ses éléments sont alors répartis dans ses enfants.
+   */
+  static constexpr size_t bucketCapacity = 0;
+
+  /**
+   * @brief Profondeur maximale du QuadTree, la racine étant au niveau 1.
+   *
+   * Les noeuds de ce niveau ne sont jamais subdivisés et gardent tous leurs éléments.
+   */
+  static constexpr size_t maxDepth = std::numeric_limits<size_t>::max();
+
+  /**
+   * @brief Facteur d'agrandissement des cellules des enfants (QuadTree "lâche").
+   *
+   * Avec 1, un élément n'est rangé dans un enfant que s'il tient dans sa cellule : les éléments qui chevauchent
+   * une médiane restent dans les niveaux supérieurs.
+   * Avec un facteur k > 1, chaque enfant accepte les éléments dont le centre est dans sa cellule et qui tiennent
+   * dans cette cellule agrandie k fois autour de son centre : chaque élément descend au niveau correspondant à sa taille.
+   */
+  static constexpr float looseness = 1.0f;
+
+  /**
+   * @brief Agrandissement automatique de la racine pour les éléments en dehors des limites du QuadTree.
+   *
+   * Avec false, insérer un tel élément lève une exception de type std::domain_error.
+   * Avec true, la racine est doublée vers l'élément autant de fois que nécessaire : l'ancienne racine devient l'un
+   * des quatre enfants de la nouvelle, sans qu'aucun élément ne soit inséré à nouveau.
+   * La profondeur d'un QuadTree extensible ne peut pas être limitée, les niveaux existants descendant d'un cran à chaque agrandissement.
+   */
+  static constexpr bool growable = false;
+
+  /**
+   * @brief Type des coordonnées du QuadTree.
+   *
+   * Avec float, les limites sont des SLimits. Avec un autre type (double pour un monde étendu où la précision des float
+   * ne suffit plus), ce sont des TLimits<coordinate> : les méthodes de l'élément sont alors converties vers ce type.
+   */
+  using coordinate = float;
+
+  /**
+   * @brief Stockage compressé des limites des éléments.
+   *
+   * Avec true, les limites recopiées dans chaque noeud pour les requêtes sont stockées sur 16 bits, relativement à la cellule
+   * (agrandie) du noeud : elles occupent deux fois moins de mémoire et un bloc de test contient deux fois plus d'éléments.
+   * Les limites sont arrondies vers l'extérieur et les requêtes de la même façon : le test des limites compressées
+   * ne manque aucun élément, et les éléments retenus sont vérifiés sur leurs limites exactes.
+   */
+  static constexpr bool quantized = false;
+
+  /**
+   * @brief Nombre d'éléments stockés dans le noeud lui-même, sans allocation (voir TSmallVector).
+   *
+   * Avec 0, la liste des données d'un noeud est un std::vector. Sinon, les noeuds grossissent d'autant d'éléments,
+   * mais un noeud qui n'en contient pas plus n'alloue rien et ses éléments sont lus sans passer par un autre bloc mémoire.
+   */
+  static constexpr size_t inlineCapacity = 0;
+};
@@ -0,0 +1,494 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define QUADTREE_X64
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(QUADTREE_X64) && defined(__GNUC__)
+//GCC et Clang n'acceptent les instructions AVX que dans les fonctions compilées pour elles
+#define QUADTREE_TARGET_AVX __attribute__((target("avx")))
+#else
+#define QUADTREE_TARGET_AVX
+#endif
+
+/**
+ * @brief Jeu d'instructions utilisé pour tester les limites des éléments.
+ */
+enum class ESimdLevel
+{
+  scalar, ///< Code C++ standard, disponible partout
+  sse,    ///< SSE, registres de 128 bits (4 float par instruction, toujours disponible en x64)
+  avx     ///< AVX, registres de 256 bits (8 float par instruction)
+};
+
+/**
+ * @brief Sélection à l'exécution du jeu d'instructions des tests de limites.
+ *
+ * Le meilleur jeu d'instructions supporté par le processeur est détecté au démarrage.
+ * Un exécutable compilé sans option particulière profite ainsi de l'AVX quand il est disponible.
+ */
+class CSimd
+{
+public:
+  /**
+   * @brief Retourne le meilleur jeu d'instructions supporté par le processeur et le système.
+   */
+  static ESimdLevel supported()
+  {
+#ifdef QUADTREE_X64
+#ifdef _MSC_VER
+    int registers[4];
+    __cpuid(registers, 1);
+    //AVX et OSXSAVE présents, et registres YMM sauvegardés par le système
+    const bool avx = (registers[2] & (1 << 28)) && (registers[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+#else
+    const bool avx = __builtin_cpu_supports("avx");
+#endif
+    return avx ? ESimdLevel::avx : ESimdLevel::sse;
+#else
+    return ESimdLevel::scalar;
+#endif
+  }
+
+  /**
+   * @brief Retourne le jeu d'instructions utilisé.
+   */
+  static ESimdLevel active()
+  {
+    return s_Active;
+  }
+
+  /**
+   * @brief Change le jeu d'instructions utilisé, pour les comparaisons et les tests.
+   *
+   * Un jeu d'instructions non supporté est remplacé par le meilleur jeu supporté.
+   *
+   * @return Le jeu d'instructions effectivement sélectionné.
+   */
+  static ESimdLevel select(ESimdLevel level)
+  {
+    s_Active = std::min(level, supported());
+    return s_Active;
+  }
+
+private:
+  static inline ESimdLevel s_Active = supported(); ///< Le jeu d'instructions utilisé
+};
+
+/**
+ * @brief Tableau des limites géométriques des éléments d'un noeud de TQuadTree.
+ *
+ * Les limites sont rangées en structure de tableaux, par blocs de width éléments :
+ * chaque bloc contient les width valeurs de x1, puis de y1, de x2 et de y2, chaque série occupant 32 octets.
+ * Un test d'intersection ne lit ainsi que des coordonnées contiguës, sans toucher aux éléments eux-mêmes,
+ * et un bloc entier peut être testé d'un coup.
+ *
+ * Les emplacements inutilisés du dernier bloc valent NaN : toute comparaison avec eux est fausse,
+ * ils ne satisfont donc jamais un test et n'ont pas besoin d'être exclus.
+ * Pour des coordonnées entières, ils valent 0 et sont retirés du masque du dernier bloc.
+ *
+ * Les tests d'un bloc sont faits avec le jeu d'instructions choisi par CSimd.
+ *
+ * @tparam Coordinate Le type des coordonnées : float, double, ou uint16_t pour des limites compressées.
+ * @tparam Allocator L'allocateur utilisé pour les blocs (converti vers le type des blocs).
+ */
+template <typename Coordinate = float, typename Allocator = std::allocator<Coordinate>>
+class TBoundsArray
+{
+  static_assert(std::is_same_v<Coordinate, float> || std::is_same_v<Coordinate, double> || std::is_same_v<Coordinate, uint16_t>,
+    "Les tests SSE et AVX traitent des float, des double ou des uint16_t");
+
+public:
+  /// Nombre d'éléments par bloc : une série de coordonnées d'un bloc remplit un registre AVX.
+  static constexpr size_t width = 32 / sizeof(Coordinate);
+
+  /**
+   * @brief Bloc de limites de width éléments.
+   */
+  struct alignas(32) SBlock
+  {
+    Coordinate x1[width]; ///< Les coordonnées x des coins supérieurs gauches
+    Coordinate y1[width]; ///< Les coordonnées y des coins supérieurs gauches
+    Coordinate x2[width]; ///< Les coordonnées x des coins inférieurs droits
+    Coordinate y2[width]; ///< Les coordonnées y des coins inférieurs droits
+  };
+
+private:
+  std::vector<SBlock, typename std::allocator_traits<Allocator>::template rebind_alloc<SBlock>> m_Blocks; ///< Les blocs de limites
+  size_t m_Size = 0; ///< Le nombre d'éléments
+
+public:
+  /// Valeur des emplacements inutilisés : NaN, ou 0 pour des coordonnées entières.
+  static constexpr Coordinate unused = std::numeric_limits<Coordinate>::quiet_NaN();
+
+  /**
+   * @brief Retourne un bloc dont tous les emplacements sont inutilisés.
+   */
+  static SBlock emptyBlock()
+  {
+    SBlock block;
+    for (size_t lane = 0; lane < width; ++lane)
+      block.x1[lane] = block.y1[lane] = block.x2[lane] = block.y2[lane] = unused;
+    return block;
+  }
+
+private:
+  /**
+   * @brief Teste des blocs contre une zone, sans instruction particulière.
+   *
+   * @tparam Inscribed true pour le test d'inclusion, false pour le test de collision.
+   * @param blocks Les blocs à tester.
+   * @param count Le nombre de blocs.
+   * @param [out] masks Le masque de chaque bloc.
+   */
+  template <bool Inscribed>
+  static void testScalar(const SBlock* blocks, size_t count, Coordinate x1, Coordinate y1, Coordinate x2, Coordinate y2, unsigned* masks)
+  {
+    for (size_t block = 0; block < count; ++block)
+    {
+      const SBlock& b = blocks[block];
+      unsigned mask = 0;
+      for (size_t lane = 0; lane < width; ++lane)
+      {
+        bool hit;
+        if constexpr (Inscribed)
+          hit = (b.x1[lane] >= x1) & (b.x2[lane] <= x2) & (b.y1[lane] >= y1) & (b.y2[lane] <= y2);
+        else
+          hit = (b.x1[lane] <= x2) & (b.x2[lane] >= x1) & (b.y1[lane] <= y2) & (b.y2[lane] >= y1);
+        mask |= unsigned(hit) << lane;
+      }
+      masks[block] = mask;
+    }
+  }
+
+#ifdef QUADTREE_X64
+  /**
+   * @brief Teste des blocs contre une zone en SSE, par registres de 128 bits (voir testScalar).
+   *
+   * Les comparaisons ordonnées sont fausses pour les emplacements NaN.
+   * Le SSE2 ne comparant que des entiers signés, les uint16_t sont décalés de 0x8000 avant d'être comparés.
+   */
+  template <bool Inscribed>
+  static void testSse(const SBlock* blocks, size_t count, Coordinate x1, Coordinate y1, Coordinate x2, Coordinate y2, unsigned* masks)
+  {
+    if constexpr (std::is_same_v<Coordinate, float>)
+    {
+      const __m128 qx1 = _mm_set1_ps(x1), qy1 = _mm_set1_ps(y1), qx2 = _mm_set1_ps(x2), qy2 = _mm_set1_ps(y2);
+      for (size_t block = 0; block < count; ++block)
+      {
+        const SBlock& b = blocks[block];
+        unsigned mask = 0;
+        for (size_t half = 0; half < width; half += 4)
+        {
+          const __m128 bx1 = _mm_load_ps(b.x1 + half), by1 = _mm_load_ps(b.y1 + half);
+          const __m128 bx2 = _mm_load_ps(b.x2 + half), by2 = _mm_load_ps(b.y2 + half);
+          __m128 hit;
+          if constexpr (Inscribed)
+            hit = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(bx1, qx1), _mm_cmple_ps(bx2, qx2)),
+                             _mm_and_ps(_mm_cmpge_ps(by1, qy1), _mm_cmple_ps(by2, qy2)));
+          else
+            hit = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(bx1, qx2), _mm_cmpge_ps(bx2, qx1)),
+                             _mm_and_ps(_mm_cmple_ps(by1, qy2), _mm_cmpge_ps(by2, qy1)));
+          mask |= unsigned(_mm_movemask_ps(hit)) << half;
+        }
+        masks[block] = mask;
+      }
+    }
+    else if constexpr (std::is_same_v<Coordinate, double>)
+    {
+      const __m128d qx1 = _mm_set1_pd(x1), qy1 = _mm_set1_pd(y1), qx2 = _mm_set1_pd(x2), qy2 = _mm_set1_pd(y2);
+      for (size_t block = 0; block < count; ++block)
+      {
+        const SBlock& b = blocks[block];
+        unsigned mask = 0;
+        for (size_t pair = 0; pair < width; pair += 2)
+        {
+          const __m128d bx1 = _mm_load_pd(b.x1 + pair), by1 = _mm_load_pd(b.y1 + pair);
+          const __m128d bx2 = _mm_load_pd(b.x2 + pair), by2 = _mm_load_pd(b.y2 + pair);
+          __m128d hit;
+          if constexpr (Inscribed)
+            hit = _mm_and_pd(_mm_and_pd(_mm_cmpge_pd(bx1, qx1), _mm_cmple_pd(bx2, qx2)),
+                             _mm_and_pd(_mm_cmpge_pd(by1, qy1), _mm_cmple_pd(by2, qy2)));
+          else
+            hit = _mm_and_pd(_mm_and_pd(_mm_cmple_pd(bx1, qx2), _mm_cmpge_pd(bx2, qx1)),
+                             _mm_and_pd(_mm_cmple_pd(by1, qy2), _mm_cmpge_pd(by2, qy1)));
+          mask |= unsigned(_mm_movemask_pd(hit)) << pair;
+        }
+        masks[block] = mask;
+      }
+    }
+    else
+    {
+      const __m128i bias = _mm_set1_epi16(short(0x8000));
+      const __m128i qx1 = _mm_xor_si128(_mm_set1_epi16(short(x1)), bias), qy1 = _mm_xor_si128(_mm_set1_epi16(short(y1)), bias);
+      const __m128i qx2 = _mm_xor_si128(_mm_set1_epi16(short(x2)), bias), qy2 = _mm_xor_si128(_mm_set1_epi16(short(y2)), bias);
+      auto load = [&bias](const Coordinate* p) { return _mm_xor_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(p)), bias); };
+      for (size_t block = 0; block < count; ++block)
+      {
+        const SBlock& b = blocks[block];
+        //Les comparaisons calculent les éléments qui ne satisfont pas le test, par moitiés de 8 éléments
+        __m128i miss[2];
+        for (size_t half = 0; half < 2; ++half)
+        {
+          const __m128i bx1 = load(b.x1 + 8 * half), by1 = load(b.y1 + 8 * half);
+          const __m128i bx2 = load(b.x2 + 8 * half), by2 = load(b.y2 + 8 * half);
+          if constexpr (Inscribed)
+            miss[half] = _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi16(qx1, bx1), _mm_cmpgt_epi16(bx2, qx2)),
+                                      _mm_or_si128(_mm_cmpgt_epi16(qy1, by1), _mm_cmpgt_epi16(by2, qy2)));
+          else
+            miss[half] = _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi16(bx1, qx2), _mm_cmpgt_epi16(qx1, bx2)),
+                                      _mm_or_si128(_mm_cmpgt_epi16(by1, qy2), _mm_cmpgt_epi16(qy1, by2)));
+        }
+        masks[block] = ~unsigned(_mm_movemask_epi8(_mm_packs_epi16(miss[0], miss[1]))) & 0xFFFFu;
+      }
+    }
+  }
+
+  /**
+   * @brief Teste des blocs contre une zone en AVX, les éléments d'un bloc à la fois (voir testScalar).
+   *
+   * La boucle sur les blocs est dans la fonction compilée pour l'AVX : sans option de compilation AVX,
+   * un appel par bloc coûterait plus cher que le test lui-même.
+   * Les comparaisons ordonnées (_OQ) sont fausses pour les emplacements NaN.
+   * L'AVX ne comparant pas les entiers (il faut l'AVX2), les uint16_t sont testés en SSE.
+   */
+  template <bool Inscribed>
+  QUADTREE_TARGET_AVX static void testAvx(const SBlock* blocks, size_t count, Coordinate x1, Coordinate y1, Coordinate x2, Coordinate y2, unsigned* masks)
+  {
+    if constexpr (std::is_same_v<Coordinate, float>)
+    {
+      const __m256 qx1 = _mm256_set1_ps(x1), qy1 = _mm256_set1_ps(y1), qx2 = _mm256_set1_ps(x2), qy2 = _mm256_set1_ps(y2);
+      for (size_t block = 0; block < count; ++block)
+      {
+        const SBlock& b = blocks[block];
+        const __m256 bx1 = _mm256_load_ps(b.x1), by1 = _mm256_load_ps(b.y1);
+        const __m256 bx2 = _mm256_load_ps(b.x2), by2 = _mm256_load_ps(b.y2);
+        __m256 hit;
+        if constexpr (Inscribed)
+          hit = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(bx1, qx1, _CMP_GE_OQ), _mm256_cmp_ps(bx2, qx2, _CMP_LE_OQ)),
+                              _mm256_and_ps(_mm256_cmp_ps(by1, qy1, _CMP_GE_OQ), _mm256_cmp_ps(by2, qy2, _CMP_LE_OQ)));
+        else
+          hit = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(bx1, qx2, _CMP_LE_OQ), _mm256_cmp_ps(bx2, qx1, _CMP_GE_OQ)),
+                              _mm256_and_ps(_mm256_cmp_ps(by1, qy2, _CMP_LE_OQ), _mm256_cmp_ps(by2, qy1, _CMP_GE_OQ)));
+        masks[block] = unsigned(_mm256_movemask_ps(hit));
+      }
+    }
+    else if constexpr (std::is_same_v<Coordinate, double>)
+    {
+      const __m256d qx1 = _mm256_set1_pd(x1), qy1 = _mm256_set1_pd(y1), qx2 = _mm256_set1_pd(x2), qy2 = _mm256_set1_pd(y2);
+      for (size_t block = 0; block < count; ++block)
+      {
+        const SBlock& b = blocks[block];
+        const __m256d bx1 = _mm256_load_pd(b.x1), by1 = _mm256_load_pd(b.y1);
+        const __m256d bx2 = _mm256_load_pd(b.x2), by2 = _mm256_load_pd(b.y2);
+        __m256d hit;
+        if constexpr (Inscribed)
+          hit = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(bx1, qx1, _CMP_GE_OQ), _mm256_cmp_pd(bx2, qx2, _CMP_LE_OQ)),
+                              _mm256_and_pd(_mm256_cmp_pd(by1, qy1, _CMP_GE_OQ), _mm256_cmp_pd(by2, qy2, _CMP_LE_OQ)));
+        else
+          hit = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(bx1, qx2, _CMP_LE_OQ), _mm256_cmp_pd(bx2, qx1, _CMP_GE_OQ)),
+                              _mm256_and_pd(_mm256_cmp_pd(by1, qy2, _CMP_LE_OQ), _mm256_cmp_pd(by2, qy1, _CMP_GE_OQ)));
+        masks[block] = unsigned(_mm256_movemask_pd(hit));
+      }
+    }
+    else
+      testSse<Inscribed>(blocks, count, x1, y1, x2, y2, masks);
+  }
+#endif
+
+  /**
+   * @brief Teste des blocs consécutifs contre une zone avec un jeu d'instructions donné.
+   */
+  template <bool Inscribed>
+  void test(size_t first, size_t count, Coordinate x1, Coordinate y1, Coordinate x2, Coordinate y2, unsigned* masks, ESimdLevel level) const
+  {
+    testBlocks<Inscribed>(m_Blocks.data() + first, count, x1, y1, x2, y2, masks, level);
+    if constexpr (std::is_integral_v<Coordinate>)
+      if (count != 0 && first + count == m_Blocks.size())
+        masks[count - 1] &= usedMask(first + count - 1);
+  }
+
+public:
+  /**
+   * @brief Teste des blocs rangés hors d'un TBoundsArray (voir TFrozenQuadTree) contre une zone.
+   *
+   * Pour des coordonnées entières, les emplacements inutilisés (0) ne sont pas retirés des masques.
+   *
+   * @tparam Inscribed true pour le test d'inclusion, false pour le test de collision.
+   * @param blocks Les blocs à tester, alignés sur 32 octets.
+   * @param count Le nombre de blocs.
+   * @param [out] masks Le masque de chaque bloc, dont le bit i correspond à l'élément i du bloc.
+   * @param level Le jeu d'instructions à utiliser, qui doit être supporté.
+   */
+  template <bool Inscribed>
+  static void testBlocks(const SBlock* blocks, size_t count, Coordinate x1, Coordinate y1, Coordinate x2, Coordinate y2, unsigned* masks,
+    ESimdLevel level = CSimd::active())
+  {
+    switch (level)
+    {
+#ifdef QUADTREE_X64
+    case ESimdLevel::avx:
+      testAvx<Inscribed>(blocks, count, x1, y1, x2, y2, masks);
+      break;
+    case ESimdLevel::sse:
+      testSse<Inscribed>(blocks, count, x1, y1, x2, y2, masks);
+      break;
+#endif
+    default:
+      testScalar<Inscribed>(blocks, count, x1, y1, x2, y2, masks);
+    }
+  }
+
+  /**
+   * @brief Constructeur de la classe TBoundsArray.
+   *
+   * @param allocator L'allocateur à utiliser.
+   */
+  explicit TBoundsArray(const Allocator& allocator = Allocator())
+    : m_Blocks(allocator)
+  {
+  }
+
+  /**
+   * @brief Retourne le nombre d'éléments.
+   */
+  size_t size() const
+  {
+    return m_Size;
+  }
+
+  /**
+   * @brief Retourne le nombre de blocs.
+   */
+  size_t blockCount() const
+  {
+    return m_Blocks.size();
+  }
+
+  /**
+   * @brief Retourne les blocs de limites.
+   */
+  const SBlock* blocks() const
+  {
+    return m_Blocks.data();
+  }
+
+  /**
+   * @brief Réserve la place pour count éléments.
+   */
+  void reserve(size_t count)
+  {
+    m_Blocks.reserve((count + width - 1) / width);
+  }
+
+  /**
+   * @brief Ajoute les limites d'un élément à la fin du tableau.
+   */
+  void push_back(Coordinate x1, Coordinate y1, Coordinate x2, Coordinate y2)
+  {
+    if (m_Size % width == 0)
+      m_Blocks.push_back(emptyBlock());
+    SBlock& block = m_Blocks[m_Size / width];
+    const size_t lane = m_Size % width;
+    block.x1[lane] = x1;
+    block.y1[lane] = y1;
+    block.x2[lane] = x2;
+    block.y2[lane] = y2;
+    ++m_Size;
+  }
+
+  /**
+   * @brief Remplace les limites d'un élément.
+   */
+  void set(size_t index, Coordinate x1, Coordinate y1, Coordinate x2, Coordinate y2)
+  {
+    SBlock& block = m_Blocks[index / width];
+    const size_t lane = index % width;
+    block.x1[lane] = x1;
+    block.y1[lane] = y1;
+    block.x2[lane] = x2;
+    block.y2[lane] = y2;
+  }
+
+  /**
+   * @brief Retire les limites d'un élément en les remplaçant par celles du dernier élément.
+   *
+   * C'est la même opération que celle appliquée à la liste des éléments lors d'un retrait, l'ordre restant ainsi identique.
+   *
+   * @param index L'index de l'élément à retirer.
+   */
+  void erase(size_t index)
+  {
+    --m_Size;
+    SBlock& last = m_Blocks[m_Size / width];
+    const size_t lastLane = m_Size % width;
+    SBlock& block = m_Blocks[index / width];
+    const size_t lane = index % width;
+    block.x1[lane] = last.x1[lastLane];
+    block.y1[lane] = last.y1[lastLane];
+    block.x2[lane] = last.x2[lastLane];
+    block.y2[lane] = last.y2[lastLane];
+    if (lastLane == 0)
+      m_Blocks.pop_back();
+    else
+      last.x1[lastLane] = last.y1[lastLane] = last.x2[lastLane] = last.y2[lastLane] = unused;
+  }
+
+  /**
+   * @brief Vide le tableau.
+   */
+  void clear()
+  {
+    m_Blocks.clear();
+    m_Size = 0;
+  }
+
+  /**
+   * @brief Calcule les masques des éléments de blocs consécutifs en collision avec une zone (bords inclus).
+   *
+   * @param first Le premier bloc.
+   * @param count Le nombre de blocs.
+   * @param [out] masks Le masque de chaque bloc, dont le bit i correspond à l'élément i du bloc.
+   * @param level Le jeu d'instructions à utiliser, qui doit être supporté.
+   */
+  void collidingMasks(size_t first, size_t count, Coordinate x1, Coordinate y1, Coordinate x2, Coordinate y2, unsigned* masks,
+    ESimdLevel level = CSimd::active()) const
+  {
+    test<false>(first, count, x1, y1, x2, y2, masks, level);
+  }
+
+  /**
+   * @brief Calcule les masques des éléments de blocs consécutifs totalement inclus dans une zone (bords inclus).
+   *
+   * @param first Le premier bloc.
+   * @param count Le nombre de blocs.
+   * @param [out] masks Le masque de chaque bloc, dont le bit i correspond à l'élément i du bloc.
+   * @param level Le jeu d'instructions à utiliser, qui doit être supporté.
+   */
+  void inscribedMasks(size_t first, size_t count, Coordinate x1, Coordinate y1, Coordinate x2, Coordinate y2, unsigned* masks,
+    ESimdLevel level = CSimd::active()) const
+  {
+    test<true>(first, count, x1, y1, x2, y2, masks, level);
+  }
+
+  /**
+   * @brief Retourne le masque des éléments utilisés d'un bloc.
+   */
+  unsigned usedMask(size_t block) const
+  {
+    const size_t used = block + 1 < m_Blocks.size() || m_Size % width == 0 ? width : m_Size % width;
+    return (1u << used) - 1;
+  }
+};
@@ -0,0 +1,767 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "CMappedFile.h"
+#include "TQuadTree.h"
+
+/**
+ * @brief QuadTree figé : copie immuable d'un TQuadTree, rangée pour des requêtes aussi rapides que possible.
+ *
+ * Pour des données construites une fois puis interrogées un très grand nombre de fois.
+ * Tout l'index tient dans un seul tableau contigu, en trois sections commençant chacune sur une ligne de cache :
+ * - les noeuds, en largeur d'abord : la racine, puis ses enfants, puis les enfants de ceux-ci, etc.
+ *   Les quatre enfants d'un noeud se suivent ;
+ * - pour chaque groupe de quatre enfants, leurs limites en structure de tableaux, testées d'une seule comparaison SSE ;
+ * - les limites des éléments, par blocs de TBoundsArray, sans place perdue : les éléments d'un noeud suivent ceux du noeud
+ *   précédent, et les éléments des autres noeuds qui partagent leurs blocs sont retirés des masques.
+ * Les éléments eux-mêmes sont rangés à part, dans le même ordre : seuls ceux qui satisfont une requête sont lus.
+ *
+ * Les limites d'un enfant sont celles de son contenu (ses éléments et toute sa descendance) et non celles de sa cellule :
+ * plus serrées, elles écartent davantage de sous-arbres, et un sous-arbre vide n'est jamais visité.
+ * Les limites des éléments sont exactes, même si le QuadTree d'origine les compresse (voir SQuadTreePolicy::quantized).
+ *
+ * Les requêtes trouvent les mêmes éléments que celles du QuadTree d'origine, dans un autre ordre.
+ *
+ * Un QuadTree figé peut être enregistré dans un fichier (save) puis projeté en mémoire (mapFile) : il répond alors
+ * aussitôt aux requêtes, sans rien reconstruire ni copier. Immuable, un QuadTree figé partage sa mémoire avec ses copies.
+ *
+ * @tparam T Le type des données stockées.
+ * @tparam Policy La politique du QuadTree d'origine, qui fixe le type des coordonnées.
+ */
+template <QuadTreeData T, typename Policy = SQuadTreePolicy>
+class TFrozenQuadTree
+{
+public:
+  using container = std::vector<T>;
+  using policy_type = Policy;
+  /// Type des coordonnées (voir SQuadTreePolicy::coordinate).
+  using coordinate = typename Policy::coordinate;
+  /// Type des limites géométriques, le même que celui du QuadTree d'origine.
+  using limits_type = typename TQuadTree<T, Policy>::limits_type;
+
+private:
+  using bounds_array = TBoundsArray<coordinate>;
+  using block = typename bounds_array::SBlock;
+
+  /// Index représentant l'absence d'enfant.
+  static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @brief Type de requête géométrique appliquée lors d'un parcours.
+   */
+  enum class EQuery
+  {
+    colliding, ///< Les éléments en collision avec les limites de la requête
+    inscribed  ///< Les éléments totalement inclus dans les limites de la requête
+  };
+
+  /**
+   * @brief Noeud du QuadTree figé.
+   */
+  struct SNode
+  {
+    uint32_t firstChild;   ///< Index du premier des quatre enfants, npos si le noeud n'a pas d'enfant
+    uint32_t firstElement; ///< Index du premier élément du noeud dans la liste des éléments et dans les limites des éléments
+    uint32_t elementCount; ///< Nombre d'éléments du noeud
+  };
+
+  /**
+   * @brief Limites du contenu d'un groupe de quatre enfants, en structure de tableaux.
+   *
+   * Un enfant sans contenu a des limites NaN : il ne satisfait aucune comparaison.
+   */
+  struct alignas(16) SChildren
+  {
+    coordinate x1[4]; ///< Les coordonnées x des coins supérieurs gauches
+    coordinate y1[4]; ///< Les coordonnées y des coins supérieurs gauches
+    coordinate x2[4]; ///< Les coordonnées x des coins inférieurs droits
+    coordinate y2[4]; ///< Les coordonnées y des coins inférieurs droits
+  };
+
+  /**
+   * @brief Ligne de cache, unité d'allocation de l'index.
+   */
+  struct alignas(64) SLine
+  {
+    unsigned char bytes[64];
+  };
+
+  /**
+   * @brief Mémoire d'un QuadTree figé construit à partir d'un QuadTree.
+   */
+  struct SStorage
+  {
+    std::vector<SLine> index; ///< Les noeuds, les limites des groupes d'enfants puis les limites des éléments
+    container elements;       ///< Les éléments, noeud par noeud dans l'ordre des noeuds
+  };
+
+  /**
+   * @brief En-tête d'un fichier de QuadTree figé (voir save).
+   *
+   * Les positions des sections sont relatives au début du fichier, sauf celles des sections de l'index,
+   * relatives au début de l'index. Les limites sont stockées en double quel que soit le type des coordonnées.
+   */
+  struct SFileHeader
+  {
+    char magic[8];             ///< Signature du format
+    uint32_t version;          ///< Version du format
+    uint32_t byteOrder;        ///< fileByteOrder écrit dans l'ordre des octets de la machine qui a écrit le fichier
+    uint32_t coordinateSize;   ///< Taille d'une coordonnée
+    uint32_t elementSize;      ///< Taille d'un élément
+    uint32_t elementAlignment; ///< Alignement d'un élément
+    uint32_t reserved;         ///< Réservé, à 0
+    uint64_t nodeCount;        ///< Nombre de noeuds
+    uint64_t childrenOffset;   ///< Position des limites des groupes d'enfants dans l'index
+    uint64_t blocksOffset;     ///< Position des limites des éléments dans l'index
+    uint64_t indexOffset;      ///< Position de l'index dans le fichier, multiple de la taille d'une ligne de cache
+    uint64_t indexSize;        ///< Taille de l'index
+    uint64_t elementsOffset;   ///< Position des éléments dans le fichier
+    uint64_t elementCount;     ///< Nombre d'éléments
+    uint64_t depth;            ///< Profondeur maximale
+    uint64_t stackSize;        ///< Taille de la pile d'un parcours, recalculée à la lecture
+    double limits[4];          ///< Limites géométriques du QuadTree d'origine
+    double extent[4];          ///< Limites de tout le contenu
+  };
+
+  static constexpr char fileMagic[8] = { 'T', 'Q', 'T', 'F', 'R', 'O', 'Z', 'N' }; ///< Signature du format de fichier
+  static constexpr uint32_t fileVersion = 1;          ///< Version du format de fichier
+  static constexpr uint32_t fileByteOrder = 0x01020304; ///< Valeur témoin de l'ordre des octets
+
+  std::shared_ptr<const void> m_pStorage;  ///< Propriétaire de la mémoire de l'index et des éléments : SStorage ou CMappedFile
+  const unsigned char* m_pIndex = nullptr; ///< Les noeuds, les limites des groupes d'enfants puis les limites des éléments
+  size_t m_IndexSize = 0;      ///< Taille de l'index, en octets
+  size_t m_NodeCount = 0;      ///< Nombre de noeuds
+  size_t m_ChildrenOffset = 0; ///< Position des limites des groupes d'enfants dans l'index, en octets
+  size_t m_BlocksOffset = 0;   ///< Position des limites des éléments dans l'index, en octets
+  const T* m_pElements = nullptr; ///< Les éléments, noeud par noeud dans l'ordre des noeuds
+  size_t m_Size = 0;           ///< Nombre d'éléments
+  limits_type m_Limits = { 0.0f, 0.0f, 1.0f, 1.0f }; ///< Limites géométriques du QuadTree d'origine
+  limits_type m_Extent;        ///< Limites de tout le contenu, NaN si le QuadTree est vide
+  size_t m_Depth = 1;          ///< Profondeur maximale, comme celle du QuadTree d'origine
+  size_t m_StackSize = 1;      ///< Taille de la pile d'un parcours : trois enfants en attente par niveau, plus le noeud courant
+
+  /**
+   * @brief Retourne des limites vides : l'union avec d'autres limites donne ces autres limites.
+   */
+  static limits_type emptyBox()
+  {
+    constexpr coordinate infinity = std::numeric_limits<coordinate>::infinity();
+    return { infinity, infinity, -infinity, -infinity };
+  }
+
+  /**
+   * @brief Retourne l'union de deux limites.
+   */
+  static limits_type unite(const limits_type& a, const limits_type& b)
+  {
+    return { std::min(a.x1, b.x1), std::min(a.y1, b.y1), std::max(a.x2, b.x2), std::max(a.y2, b.y2) };
+  }
+
+  /**
+   * @brief Vérifie si des limites sont vides (voir emptyBox).
+   */
+  static bool isEmpty(const limits_type& box)
+  {
+    return !(box.x1 <= box.x2);
+  }
+
+  /**
+   * @brief Vérifie si deux zones sont en collision (bords inclus). Une zone NaN n'est en collision avec rien.
+   */
+  static bool isColliding(const limits_type& a, const limits_type& b)
+  {
+    return a.x1 <= b.x2 && a.x2 >= b.x1 && a.y1 <= b.y2 && a.y2 >= b.y1;
+  }
+
+  /**
+   * @brief Retourne le masque des enfants d'un groupe dont le contenu est en collision avec une zone.
+   */
+  static unsigned childMask(const SChildren& children, const limits_type& limits)
+  {
+#ifdef QUADTREE_X64
+    if constexpr (std::is_same_v<coordinate, float>)
+    {
+      //Les comparaisons ordonnées sont fausses pour les enfants sans contenu (NaN)
+      const __m128 hit = _mm_and_ps(
+        _mm_and_ps(_mm_cmple_ps(_mm_load_ps(children.x1), _mm_set1_ps(limits.x2)), _mm_cmpge_ps(_mm_load_ps(children.x2), _mm_set1_ps(limits.x1))),
+        _mm_and_ps(_mm_cmple_ps(_mm_load_ps(children.y1), _mm_set1_ps(limits.y2)), _mm_cmpge_ps(_mm_load_ps(children.y2), _mm_set1_ps(limits.y1))));
+      return unsigned(_mm_movemask_ps(hit));
+    }
+    else
+#endif
+    {
+      unsigned mask = 0;
+      for (unsigned quadrant = 0; quadrant < 4; ++quadrant)
+        mask |= unsigned((children.x1[quadrant] <= limits.x2) & (children.x2[quadrant] >= limits.x1)
+          & (children.y1[quadrant] <= limits.y2) & (children.y2[quadrant] >= limits.y1)) << quadrant;
+      return mask;
+    }
+  }
+
+  /**
+   * @brief Retourne les noeuds, la racine à l'index 0.
+   */
+  const SNode* nodes() const
+  {
+    return reinterpret_cast<const SNode*>(m_pIndex);
+  }
+
+  /**
+   * @brief Retourne les limites des groupes d'enfants : celles des enfants du noeud n sont à l'index (nodes()[n].firstChild - 1) / 4.
+   */
+  const SChildren* children() const
+  {
+    return reinterpret_cast<const SChildren*>(m_pIndex + m_ChildrenOffset);
+  }
+
+  /**
+   * @brief Retourne les blocs des limites des éléments.
+   */
+  const block* blocks() const
+  {
+    return reinterpret_cast<const block*>(m_pIndex + m_BlocksOffset);
+  }
+
+  /**
+   * @brief Appelle une fonction pour chaque élément satisfaisant une requête.
+   *
+   * Le parcours est en profondeur d'abord, avec une pile locale : seuls les enfants dont le contenu est en collision
+   * avec la zone de la requête sont empilés.
+   *
+   * @return false si la fonction a interrompu le parcours en retournant false, true sinon.
+   */
+  template <typename F>
+  bool visit(EQuery query, const limits_type& limits, F& f) const
+  {
+    if (!isColliding(m_Extent, limits))
+      return true;
+
+    uint32_t local[256];
+    std::vector<uint32_t> heap;
+    uint32_t* stack = local;
+    if (m_StackSize > std::size(local))
+    {
+      heap.resize(m_StackSize);
+      stack = heap.data();
+    }
+    const SNode* pNodes = nodes();
+    const SChildren* pChildren = children();
+    const block* pBlocks = blocks();
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top != 0)
+    {
+      const SNode& node = pNodes[stack[--top]];
+      //Les blocs qui contiennent les éléments du noeud, le premier et le dernier pouvant en contenir d'autres
+      const size_t end = node.firstElement + node.elementCount;
+      const size_t firstBlock = node.firstElement / bounds_array::width;
+      const size_t endBlock = node.elementCount == 0 ? firstBlock : (end + bounds_array::width - 1) / bounds_array::width;
+      unsigned masks[64];
+      for (size_t first = firstBlock; first < endBlock; first += std::size(masks))
+      {
+        const size_t count = std::min<size_t>(std::size(masks), endBlock - first);
+        if (query == EQuery::colliding)
+          bounds_array::template testBlocks<false>(pBlocks + first, count, limits.x1, limits.y1, limits.x2, limits.y2, masks);
+        else
+          bounds_array::template testBlocks<true>(pBlocks + first, count, limits.x1, limits.y1, limits.x2, limits.y2, masks);
+        if (first == firstBlock)
+          masks[0] &= ~0u << (node.firstElement % bounds_array::width);
+        if (first + count == endBlock && end % bounds_array::width != 0)
+          masks[count - 1] &= (1u << (end % bounds_array::width)) - 1;
+        for (size_t index = 0; index < count; ++index)
+          for (unsigned mask = masks[index]; mask != 0; mask &= mask - 1)
+          {
+            const T& t = m_pElements[(first + index) * bounds_array::width + std::countr_zero(mask)];
+            if constexpr (std::is_void_v<std::invoke_result_t<F&, const T&>>)
+              std::invoke(f, t);
+            else if (!std::invoke(f, t))
+              return false;
+          }
+      }
+      if (node.firstChild != npos)
+        //Les enfants sont empilés du dernier au premier, pour être visités dans l'ordre
+        for (unsigned mask = childMask(pChildren[(node.firstChild - 1) / 4], limits); mask != 0; )
+        {
+          const unsigned quadrant = std::bit_width(mask) - 1;
+          mask &= ~(1u << quadrant);
+          stack[top++] = node.firstChild + quadrant;
+        }
+    }
+    return true;
+  }
+
+public:
+  /**
+   * @brief Constructeur d'un QuadTree figé vide.
+   */
+  TFrozenQuadTree()
+    : m_Extent(emptyBox())
+  {
+  }
+
+  /**
+   * @brief Constructeur de la classe TFrozenQuadTree, à partir d'un QuadTree.
+   *
+   * Les éléments du QuadTree sont copiés : il peut ensuite être modifié ou détruit sans effet sur le QuadTree figé.
+   *
+   * @param qt Le QuadTree à figer.
+   */
+  template <typename Allocator>
+  explicit TFrozenQuadTree(const TQuadTree<T, Policy, Allocator>& qt)
+    : m_Limits(qt.limits())
+  {
+    using source_type = TQuadTree<T, Policy, Allocator>;
+    const auto& sources = qt.m_Nodes;
+    //Un QuadTree dont le contenu a été déplacé n'a plus de racine : le QuadTree figé est vide, comme avec le constructeur par défaut
+    if (sources.empty())
+    {
+      m_Extent = emptyBox();
+      return;
+    }
+
+    //Limites du contenu de chaque noeud, calculées des feuilles vers la racine (ordre préfixe inversé)
+    std::vector<uint32_t> preorder;
+    preorder.reserve(sources.size());
+    for (std::vector<uint32_t> pending{ 0 }; !pending.empty(); )
+    {
+      const uint32_t node = pending.back();
+      pending.pop_back();
+      preorder.push_back(node);
+      if (sources[node].firstChild != source_type::npos)
+        for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+          pending.push_back(sources[node].firstChild + quadrant);
+    }
+    std::vector<limits_type> boxes(sources.size(), emptyBox());
+    for (auto it = preorder.rbegin(); it != preorder.rend(); ++it)
+    {
+      limits_type& box = boxes[*it];
+      for (const T& t : sources[*it].elements)
+        box = unite(box, source_type::boundsOf(t));
+      if (const uint32_t firstChild = sources[*it].firstChild; firstChild != source_type::npos)
+        for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+          box = unite(box, boxes[firstChild + quadrant]);
+    }
+
+    //Noeuds en largeur d'abord : les enfants d'un noeud sans contenu ne sont pas repris
+    std::vector<uint32_t> order{ 0 };
+    std::vector<size_t> levels{ 0 };
+    std::vector<SNode> frozen;
+    std::vector<block> elementBlocks;
+    const auto pStorage = std::make_shared<SStorage>();
+    container& elements = pStorage->elements;
+    frozen.reserve(sources.size());
+    elements.reserve(qt.size());
+    size_t maxLevel = 0;
+    for (size_t index = 0; index < order.size(); ++index)
+    {
+      const auto& source = sources[order[index]];
+      SNode node{ npos, static_cast<uint32_t>(elements.size()), static_cast<uint32_t>(source.elements.size()) };
+      for (size_t slot = 0; slot < source.elements.size(); ++slot)
+      {
+        if (elements.size() % bounds_array::width == 0)
+          elementBlocks.push_back(bounds_array::emptyBlock());
+        const limits_type bounds = source_type::boundsOf(source.elements[slot]);
+        block& current = elementBlocks.back();
+        const size_t lane = elements.size() % bounds_array::width;
+        current.x1[lane] = bounds.x1;
+        current.y1[lane] = bounds.y1;
+        current.x2[lane] = bounds.x2;
+        current.y2[lane] = bounds.y2;
+        elements.push_back(source.elements[slot]);
+      }
+      if (!source.elements.empty())
+        m_Depth = std::max(m_Depth, levels[index] + 1);
+      bool descend = false;
+      if (source.firstChild != source_type::npos)
+        for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+          descend |= !isEmpty(boxes[source.firstChild + quadrant]);
+      if (descend)
+      {
+        node.firstChild = static_cast<uint32_t>(order.size());
+        for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+        {
+          order.push_back(source.firstChild + quadrant);
+          levels.push_back(levels[index] + 1);
+        }
+        maxLevel = std::max(maxLevel, levels[index] + 1);
+      }
+      frozen.push_back(node);
+    }
+    m_NodeCount = frozen.size();
+    m_StackSize = 3 * maxLevel + 1;
+
+    //Limites du contenu de chaque groupe d'enfants, NaN pour un enfant sans contenu
+    std::vector<SChildren> groups((order.size() - 1) / 4);
+    for (size_t group = 0; group < groups.size(); ++group)
+      for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+      {
+        limits_type box = boxes[order[1 + 4 * group + quadrant]];
+        if (isEmpty(box))
+          box.x1 = box.y1 = box.x2 = box.y2 = std::numeric_limits<coordinate>::quiet_NaN();
+        groups[group].x1[quadrant] = box.x1;
+        groups[group].y1[quadrant] = box.y1;
+        groups[group].x2[quadrant] = box.x2;
+        groups[group].y2[quadrant] = box.y2;
+      }
+    m_Extent = boxes[0];
+    if (isEmpty(m_Extent))
+      m_Extent.x1 = m_Extent.y1 = m_Extent.x2 = m_Extent.y2 = std::numeric_limits<coordinate>::quiet_NaN();
+
+    //Les trois sections dans un seul tableau, chacune alignée sur une ligne de cache
+    auto lines = [](size_t bytes) { return (bytes + sizeof(SLine) - 1) / sizeof(SLine) * sizeof(SLine); };
+    m_ChildrenOffset = lines(frozen.size() * sizeof(SNode));
+    m_BlocksOffset = m_ChildrenOffset + lines(groups.size() * sizeof(SChildren));
+    pStorage->index.resize(lines(m_BlocksOffset + elementBlocks.size() * sizeof(block)) / sizeof(SLine));
+    unsigned char* pIndex = reinterpret_cast<unsigned char*>(pStorage->index.data());
+    std::memcpy(pIndex, frozen.data(), frozen.size() * sizeof(SNode));
+    std::memcpy(pIndex + m_ChildrenOffset, groups.data(), groups.size() * sizeof(SChildren));
+    std::memcpy(pIndex + m_BlocksOffset, elementBlocks.data(), elementBlocks.size() * sizeof(block));
+    m_pIndex = pIndex;
+    m_IndexSize = pStorage->index.size() * sizeof(SLine);
+    m_pElements = elements.data();
+    m_Size = elements.size();
+    m_pStorage = pStorage;
+  }
+
+  /**
+   * @brief Projette en mémoire un QuadTree figé enregistré par save.
+   *
+   * Rien n'est lu ni copié : les pages du fichier sont chargées par le système lors des requêtes, et partagées entre
+   * tous les processus qui projettent le même fichier. Le fichier reste projeté tant que le QuadTree figé ou l'une
+   * de ses copies existe.
+   *
+   * L'en-tête est vérifié : signature, version, ordre des octets, taille des coordonnées et des éléments,
+   * et tailles des sections par rapport à celle du fichier. Les noeuds sont ensuite parcourus une fois : ils doivent
+   * former l'arbre écrit par save, avec des éléments dans la section des éléments et la profondeur de l'en-tête.
+   * La taille de la pile des parcours est recalculée à partir de ces noeuds. Sinon, ou si le fichier ne peut pas être
+   * projeté, une exception de type std::runtime_error est levée : un fichier corrompu ne peut faire lire aucune
+   * requête hors du fichier. Les limites, elles, ne sont pas vérifiées : si elles sont fausses, les requêtes aussi.
+   *
+   * @param path Le chemin du fichier.
+   * @return Le QuadTree figé.
+   */
+  static TFrozenQuadTree mapFile(const std::filesystem::path& path)
+    requires std::is_trivially_copyable_v<T>
+  {
+    auto pFile = std::make_shared<const CMappedFile>(path);
+    SFileHeader header;
+    if (pFile->size() < sizeof(header))
+      throw std::runtime_error("TFrozenQuadTree::mapFile : le fichier est trop court " + path.string());
+    std::memcpy(&header, pFile->data(), sizeof(header));
+    if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0 || header.version != fileVersion)
+      throw std::runtime_error("TFrozenQuadTree::mapFile : format ou version de fichier inconnu " + path.string());
+    if (header.byteOrder != fileByteOrder || header.coordinateSize != sizeof(coordinate)
+      || header.elementSize != sizeof(T) || header.elementAlignment != alignof(T))
+      throw std::runtime_error("TFrozenQuadTree::mapFile : le fichier a été écrit pour une autre machine ou un autre type " + path.string());
+
+    //Chaque section doit tenir dans le fichier, à une position alignée
+    const uint64_t size = pFile->size();
+    const uint64_t blockCount = (header.elementCount + bounds_array::width - 1) / bounds_array::width;
+    bool valid = header.indexOffset % sizeof(SLine) == 0 && header.indexOffset <= size && header.indexSize <= size - header.indexOffset
+      && header.childrenOffset % sizeof(SLine) == 0 && header.blocksOffset % sizeof(SLine) == 0
+      && header.nodeCount <= header.childrenOffset / sizeof(SNode) && header.childrenOffset <= header.blocksOffset
+      && (header.nodeCount == 0 ? 0 : (header.nodeCount - 1) / 4) <= (header.blocksOffset - header.childrenOffset) / sizeof(SChildren)
+      && header.blocksOffset <= header.indexSize && blockCount <= (header.indexSize - header.blocksOffset) / sizeof(block)
+      && header.elementsOffset % alignof(T) == 0 && header.elementsOffset <= size
+      && header.elementCount <= (size - header.elementsOffset) / sizeof(T)
+      && (header.nodeCount != 0 || header.elementCount == 0);
+
+    //Les noeuds doivent être en largeur d'abord, chaque groupe de quatre enfants suivant le précédent et son parent :
+    //sinon un parcours pourrait boucler ou déborder de sa pile. Les niveaux se déduisent alors de l'ordre des noeuds.
+    const SNode* pNodes = reinterpret_cast<const SNode*>(pFile->data() + header.indexOffset);
+    uint64_t nextChild = 1;
+    uint64_t levelEnd = 1;
+    uint64_t level = 0;
+    uint64_t depth = 1;
+    for (uint64_t index = 0; valid && index < header.nodeCount; ++index)
+    {
+      if (index == levelEnd)
+      {
+        ++level;
+        levelEnd = nextChild;
+      }
+      const SNode& node = pNodes[index];
+      if (node.firstChild != npos)
+      {
+        valid = node.firstChild == nextChild && node.firstChild > index && nextChild + 4 <= header.nodeCount;
+        nextChild += 4;
+      }
+      valid = valid && uint64_t(node.firstElement) + node.elementCount <= header.elementCount;
+      if (node.elementCount != 0)
+        depth = std::max(depth, level + 1);
+    }
+    valid = valid && (header.nodeCount == 0 || nextChild == header.nodeCount) && depth == header.depth;
+    if (!valid)
+      throw std::runtime_error("TFrozenQuadTree::mapFile : le fichier est tronqué ou corrompu " + path.string());
+
+    TFrozenQuadTree frozen;
+    frozen.m_pIndex = pFile->data() + header.indexOffset;
+    frozen.m_IndexSize = static_cast<size_t>(header.indexSize);
+    frozen.m_NodeCount = static_cast<size_t>(header.nodeCount);
+    frozen.m_ChildrenOffset = static_cast<size_t>(header.childrenOffset);
+    frozen.m_BlocksOffset = static_cast<size_t>(header.blocksOffset);
+    frozen.m_pElements = reinterpret_cast<const T*>(pFile->data() + header.elementsOffset);
+    frozen.m_Size = static_cast<size_t>(header.elementCount);
+    frozen.m_Limits = { static_cast<coordinate>(header.limits[0]), static_cast<coordinate>(header.limits[1]),
+                        static_cast<coordinate>(header.limits[2]), static_cast<coordinate>(header.limits[3]) };
+    if (header.nodeCount != 0)
+      frozen.m_Extent = { static_cast<coordinate>(header.extent[0]), static_cast<coordinate>(header.extent[1]),
+                          static_cast<coordinate>(header.extent[2]), static_cast<coordinate>(header.extent[3]) };
+    frozen.m_Depth = static_cast<size_t>(depth);
+    frozen.m_StackSize = static_cast<size_t>(3 * level + 1);
+    frozen.m_pStorage = std::move(pFile);
+    return frozen;
+  }
+
+  /**
+   * @brief Enregistre le QuadTree figé dans un fichier, pour le projeter ensuite en mémoire (voir mapFile).
+   *
+   * Le fichier contient un en-tête versionné, puis l'index et les éléments tels qu'ils sont en mémoire :
+   * il ne peut être relu que sur une machine de même ordre des octets, pour le même type d'éléments.
+   * Si le fichier ne peut pas être écrit, une exception de type std::runtime_error est levée.
+   *
+   * @param path Le chemin du fichier, remplacé s'il existe.
+   */
+  void save(const std::filesystem::path& path) const
+    requires std::is_trivially_copyable_v<T>
+  {
+    auto lines = [](uint64_t bytes) { return (bytes + sizeof(SLine) - 1) / sizeof(SLine) * sizeof(SLine); };
+    SFileHeader header{};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = fileVersion;
+    header.byteOrder = fileByteOrder;
+    header.coordinateSize = sizeof(coordinate);
+    header.elementSize = sizeof(T);
+    header.elementAlignment = alignof(T);
+    header.nodeCount = m_NodeCount;
+    header.childrenOffset = m_ChildrenOffset;
+    header.blocksOffset = m_BlocksOffset;
+    header.indexOffset = lines(sizeof(header));
+    header.indexSize = m_IndexSize;
+    header.elementsOffset = lines(header.indexOffset + m_IndexSize);
+    header.elementCount = m_Size;
+    header.depth = m_Depth;
+    header.stackSize = m_StackSize;
+    const coordinate limits[4] = { m_Limits.x1, m_Limits.y1, m_Limits.x2, m_Limits.y2 };
+    const coordinate extent[4] = { m_Extent.x1, m_Extent.y1, m_Extent.x2, m_Extent.y2 };
+    std::copy(std::begin(limits), std::end(limits), header.limits);
+    std::copy(std::begin(extent), std::end(extent), header.extent);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+      throw std::runtime_error("TFrozenQuadTree::save : impossible de créer le fichier " + path.string());
+    const char padding[sizeof(SLine)] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(padding, static_cast<std::streamsize>(header.indexOffset - sizeof(header)));
+    file.write(reinterpret_cast<const char*>(m_pIndex), static_cast<std::streamsize>(m_IndexSize));
+    file.write(padding, static_cast<std::streamsize>(header.elementsOffset - header.indexOffset - m_IndexSize));
+    file.write(reinterpret_cast<const char*>(m_pElements), static_cast<std::streamsize>(m_Size * sizeof(T)));
+    file.close();
+    if (!file)
+      throw std::runtime_error("TFrozenQuadTree::save : erreur d'écriture du fichier " + path.string());
+  }
+
+  /**
+   * @brief Retourne les limites géométriques du QuadTree d'origine.
+   */
+  limits_type limits() const
+  {
+    return m_Limits;
+  }
+
+  /**
+   * @brief Vérifie si le QuadTree figé est vide.
+   */
+  bool empty() const
+  {
+    return m_Size == 0;
+  }
+
+  /**
+   * @brief Retourne le nombre d'éléments stockés.
+   */
+  size_t size() const
+  {
+    return m_Size;
+  }
+
+  /**
+   * @brief Retourne la profondeur maximale : le nombre de niveaux jusqu'au plus profond noeud qui contient des éléments.
+   */
+  size_t depth() const
+  {
+    return m_Depth;
+  }
+
+  /**
+   * @brief Retourne le nombre de noeuds, pour les statistiques.
+   */
+  size_t nodeCount() const
+  {
+    return m_NodeCount;
+  }
+
+  /**
+   * @brief Retourne la taille de l'index (noeuds, limites des enfants et limites des éléments), en octets.
+   */
+  size_t indexSize() const
+  {
+    return m_IndexSize;
+  }
+
+  /**
+   * @brief Récupère tous les éléments stockés.
+   */
+  container getAll() const
+  {
+    return container(m_pElements, m_pElements + m_Size);
+  }
+
+  /**
+   * @brief Copie tous les éléments stockés vers un itérateur de sortie.
+   *
+   * @param out L'itérateur de sortie.
+   * @return L'itérateur de sortie après le dernier élément copié.
+   */
+  template <std::output_iterator<const T&> O>
+  O getAll(O out) const
+  {
+    return std::copy(m_pElements, m_pElements + m_Size, out);
+  }
+
+  /**
+   * @brief Trouve les éléments totalement inclus dans une zone spécifiée.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @return Une liste de tous les éléments trouvés dans la zone spécifiée.
+   */
+  container findInscribed(const limits_type& limits) const
+  {
+    container result;
+    auto add = [&result](const T& t) { result.push_back(t); };
+    visit(EQuery::inscribed, limits, add);
+    return result;
+  }
+
+  /**
+   * @brief Trouve les éléments en collision avec une zone spécifiée.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @return Une liste de tous les éléments trouvés dans la zone spécifiée.
+   */
+  container findColliding(const limits_type& limits) const
+  {
+    container result;
+    auto add = [&result](const T& t) { result.push_back(t); };
+    visit(EQuery::colliding, limits, add);
+    return result;
+  }
+
+  /**
+   * @brief Copie les éléments totalement inclus dans une zone spécifiée vers un itérateur de sortie.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @param out L'itérateur de sortie.
+   * @return L'itérateur de sortie après le dernier élément copié.
+   */
+  template <std::output_iterator<const T&> O>
+  O findInscribed(const limits_type& limits, O out) const
+  {
+    auto copy = [&out](const T& t) { *out++ = t; };
+    visit(EQuery::inscribed, limits, copy);
+    return out;
+  }
+
+  /**
+   * @brief Ajoute à une liste l'adresse des éléments totalement inclus dans une zone spécifiée.
+   *
+   * Aucun élément n'est copié et la liste n'est pas vidée. Les adresses restent valides tant que le QuadTree figé existe.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @param [in,out] result La liste à laquelle les adresses sont ajoutées.
+   */
+  void findInscribed(const limits_type& limits, std::vector<const T*>& result) const
+  {
+    auto add = [&result](const T& t) { result.push_back(&t); };
+    visit(EQuery::inscribed, limits, add);
+  }
+
+  /**
+   * @brief Copie les éléments en collision avec une zone spécifiée vers un itérateur de sortie.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @param out L'itérateur de sortie.
+   * @return L'itérateur de sortie après le dernier élément copié.
+   */
+  template <std::output_iterator<const T&> O>
+  O findColliding(const limits_type& limits, O out) const
+  {
+    auto copy = [&out](const T& t) { *out++ = t; };
+    visit(EQuery::colliding, limits, copy);
+    return out;
+  }
+
+  /**
+   * @brief Ajoute à une liste l'adresse des éléments en collision avec une zone spécifiée.
+   *
+   * Aucun élément n'est copié et la liste n'est pas vidée. Les adresses restent valides tant que le QuadTree figé existe.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @param [in,out] result La liste à laquelle les adresses sont ajoutées.
+   */
+  void findColliding(const limits_type& limits, std::vector<const T*>& result) const
+  {
+    auto add = [&result](const T& t) { result.push_back(&t); };
+    visit(EQuery::colliding, limits, add);
+  }
+
+  /**
+   * @brief Appelle une fonction pour chaque élément totalement inclus dans une zone spécifiée.
+   *
+   * La requête n'alloue rien. Si la fonction retourne un booléen, le parcours s'arrête dès qu'elle retourne false.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @param f La fonction appelée avec chaque élément trouvé (const T&).
+   * @return false si le parcours a été interrompu par la fonction, true sinon.
+   */
+  template <typename F>
+    requires std::invocable<F&, const T&>
+  bool forEachInscribed(const limits_type& limits, F&& f) const
+  {
+    return visit(EQuery::inscribed, limits, f);
+  }
+
+  /**
+   * @brief Appelle une fonction pour chaque élément en collision avec une zone spécifiée.
+   *
+   * La requête n'alloue rien. Si la fonction retourne un booléen, le parcours s'arrête dès qu'elle retourne false.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @param f La fonction appelée avec chaque élément trouvé (const T&).
+   * @return false si le parcours a été interrompu par la fonction, true sinon.
+   */
+  template <typename F>
+    requires std::invocable<F&, const T&>
+  bool forEachColliding(const limits_type& limits, F&& f) const
+  {
+    return visit(EQuery::colliding, limits, f);
+  }
+};
+
+/**
+ * @brief Guide de déduction : le QuadTree figé d'un TQuadTree a les mêmes données et la même politique.
+ */
+template <QuadTreeData T, typename Policy, typename Allocator>
+TFrozenQuadTree(const TQuadTree<T, Policy, Allocator>&) -> TFrozenQuadTree<T, Policy>;
@@ -0,0 +1,17 @@
+#pragma once
+
+/**
+ * @brief Structure définissant les limites d'une zone rectangulaire, pour un type de coordonnées autre que float.
+ *
+ * @tparam Coordinate Le type des coordonnées (voir SQuadTreePolicy::coordinate).
+ */
+template <typename Coordinate>
+struct TLimits
+{
+  Coordinate x1; ///< La coordonnée x du coin supérieur gauche.
+  Coordinate y1; ///< La coordonnée y du coin supérieur gauche.
+  Coordinate x2; ///< La coordonnée x du coin inférieur droit.
+  Coordinate y2; ///< La coordonnée y du coin inférieur droit.
+
+  bool operator==(const TLimits& other) const = default;
+};
@@ -1,6 +1,25 @@
 #pragma once
 //Evidemment, il va falloir inclure les fichiers nécessaires pour que le code compile
 #include <vector>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <queue>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include "Distances.h"
+#include "QueryShapes.h"
+#include "SQuadTreePolicy.h"
+#include "TBoundsArray.h"
+#include "TLimits.h"
+#include "TSmallVector.h"
 
 //Vous n'avez pas le droit de modifier cette partie du code jusqu'à la ligne notée par le commentaire //Vous pouvez modifier le code ci-dessous
 #include <concepts>
@@ -51,14 +70,79 @@ struct SLimits
  *
  * @tparam T Le type des données à stocker.
  * T doit respecter le concept QuadTreeData.
+ * @tparam Policy La politique de subdivision (voir SQuadTreePolicy).
+ * @tparam Allocator L'allocateur utilisé pour les noeuds et pour les listes de données des noeuds.
+ * Il est converti (rebind) vers les types internes, un std::pmr::polymorphic_allocator permet ainsi
+ * de placer tout le QuadTree dans une arène (voir TPmrQuadTree).
  */
-template <QuadTreeData T>
+template <QuadTreeData T, typename Policy = SQuadTreePolicy, typename Allocator = std::allocator<T>>
 class TQuadTree
 {
   //Vous pouvez modifier le code ci-dessous
   //Attention à ne pas modifier les signatures des fonctions et des méthodes qui sont déjà présentes
+  static_assert(Policy::maxDepth >= 1, "La profondeur maximale doit inclure la racine");
+  static_assert(Policy::looseness >= 1.0f, "Le facteur d'agrandissement des cellules ne peut pas les réduire");
+  static_assert(!Policy::growable || Policy::maxDepth == std::numeric_limits<size_t>::max(),
+    "Un QuadTree extensible ne peut pas limiter sa profondeur");
+  static_assert(std::floating_point<typename Policy::coordinate>, "Les coordonnées doivent être des nombres à virgule flottante");
+
+  //Le QuadTree figé est construit directement à partir des noeuds
+  template <QuadTreeData, typename>
+  friend class TFrozenQuadTree;
+
 public:
   using container = std::vector<T>;
+  using policy_type = Policy;
+  using allocator_type = Allocator;
+  /// Type des coordonnées (voir SQuadTreePolicy::coordinate).
+  using coordinate = typename Policy::coordinate;
+  /// Limites d'une zone : SLimits pour des coordonnées float, TLimits sinon.
+  using limits_type = std::conditional_t<std::is_same_v<coordinate, float>, SLimits, TLimits<coordinate>>;
+  /// Disque de requête dans les coordonnées du QuadTree (voir QueryShape).
+  using circle_type = TCircle<coordinate>;
+  /// Polygone convexe de requête dans les coordonnées du QuadTree (voir QueryShape).
+  using polygon_type = TConvexPolygon<coordinate>;
+
+private:
+  /// Liste des données d'un noeud, allouée avec l'allocateur du QuadTree au-delà de Policy::inlineCapacity éléments.
+  using bucket = std::conditional_t<Policy::inlineCapacity == 0,
+    std::vector<T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>,
+    TSmallVector<T, std::max<size_t>(Policy::inlineCapacity, 1), typename std::allocator_traits<Allocator>::template rebind_alloc<T>>>;
+  /// Type des limites recopiées dans les noeuds : les coordonnées, ou des entiers relatifs à la cellule (voir SQuadTreePolicy::quantized).
+  using stored_coordinate = std::conditional_t<Policy::quantized, uint16_t, coordinate>;
+  /// Limites des données d'un noeud, dans le même ordre que la liste des données.
+  using bounds_array = TBoundsArray<stored_coordinate, Allocator>;
+  /// Liste d'index (identifiants des données d'un noeud, groupes d'enfants libres), allouée avec l'allocateur du QuadTree.
+  using index_list = std::vector<uint32_t, typename std::allocator_traits<Allocator>::template rebind_alloc<uint32_t>>;
+
+  /// Index représentant l'absence de noeud (pas d'enfant, pas de parent ou fin de parcours).
+  static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @brief Type de requête géométrique appliquée lors d'un parcours.
+   */
+  enum class EQuery
+  {
+    all,       ///< Tous les éléments
+    colliding, ///< Les éléments en collision avec les limites de la requête
+    inscribed  ///< Les éléments totalement inclus dans les limites de la requête
+  };
+
+public:
+  /**
+   * @brief Identifiant stable d'un élément, retourné par insertWithHandle.
+   *
+   * Il reste valide jusqu'au retrait de l'élément, quels que soient ses déplacements dans le QuadTree
+   * (subdivisions, retraits d'autres éléments, mises à jour).
+   * Un identifiant d'élément retiré est reconnu comme invalide, même si son emplacement a été réutilisé depuis.
+   */
+  struct handle
+  {
+    uint32_t id = npos;      ///< Index dans la table des emplacements
+    uint32_t generation = 0; ///< Génération de l'emplacement lors de l'insertion
+
+    bool operator==(const handle& other) const = default;
+  };
 
   /**
     * @brief Itérateur pour parcourir les éléments du QuadTree.
@@ -74,14 +158,63 @@ public:
     using iterator_category = std::input_iterator_tag;
 
   private:
+    friend class TQuadTree;
+
+    TQuadTree* m_pTree = nullptr; ///< QuadTree parcouru, nullptr pour l'itérateur de fin
+    EQuery m_Query = EQuery::all; ///< Type de requête filtrant les éléments
+    limits_type m_Limits = {};    ///< Limites de la requête
+    uint32_t m_Node = npos;       ///< Index du noeud courant
+    size_t m_Index = 0;           ///< Index de l'élément courant dans le noeud courant
+
+    /**
+     * @brief Construit un itérateur positionné sur le premier élément satisfaisant la requête.
+     *
+     * @param pTree Le QuadTree à parcourir.
+     * @param query Le type de requête.
+     * @param limits Les limites de la requête.
+     */
+    iterator(TQuadTree* pTree, EQuery query, const limits_type& limits)
+      : m_pTree(pTree), m_Query(query), m_Limits(limits), m_Node(pTree->first(query, limits))
+    {
+      settle();
+    }
+
+    /**
+     * @brief Avance l'itérateur jusqu'au prochain élément satisfaisant la requête, à partir de la position courante.
+     *
+     * Si aucun élément n'est trouvé, l'itérateur devient l'itérateur de fin.
+     */
+    void settle()
+    {
+      while (m_Node != npos)
+      {
+        //Les éléments sont testés par blocs sur leurs limites, un élément n'est lu que s'il satisfait la requête
+        //Dans un noeud dont la cellule est incluse dans la zone de la requête, tous les éléments la satisfont
+        const SNode& node = m_pTree->m_Nodes[m_Node];
+        const EQuery query = covers(node.limits, m_Query, m_Limits) ? EQuery::all : m_Query;
+        while (m_Index < node.bounds.size())
+        {
+          unsigned mask;
+          m_pTree->matchMasks(node, m_Index / bounds_array::width, 1, query, m_Limits, &mask);
+          mask >>= m_Index % bounds_array::width;
+          if (mask != 0)
+          {
+            m_Index += std::countr_zero(mask);
+            return;
+          }
+          m_Index += bounds_array::width - m_Index % bounds_array::width;
+        }
+        m_Node = m_pTree->next(m_Node, true, m_Query, m_Limits);
+        m_Index = 0;
+      }
+      m_pTree = nullptr;
+    }
 
   public:
     /**
      * @brief Constructeur par défaut de l'itérateur.
      * 
-     * Evidemment, il va falloir compléter cette fonction pour qu'elle initialise correctement l'itérateur.
-     * Peut-être que l'itérateur devrait être initialisé à la fin de la liste de données.
-     * Peut-etre qu'on peut ajouter d'autres constructeurs pour initialiser l'itérateur à un endroit spécifique.
+     * Un itérateur construit par défaut est l'itérateur de fin.
      */
     iterator() = default;
 
@@ -92,8 +225,7 @@ public:
      */
     bool operator==(const iterator& other) const
     {
-      //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne true si les deux itérateurs sont à la même position
-      return true;
+      return m_pTree == other.m_pTree && m_Node == other.m_Node && m_Index == other.m_Index;
     }
 
     /**
@@ -103,7 +235,8 @@ public:
      */
     iterator& operator++()
     {
-      //Evidemment, il va falloir compléter cette fonction pour qu'elle avance l'itérateur à la prochaine position valide
+      ++m_Index;
+      settle();
       return *this;
     }
 
@@ -116,8 +249,9 @@ public:
      */
     iterator operator++(int)
     {
-      //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne l'itérateur courant avant d'être avancé
-      return {};
+      iterator previous = *this;
+      ++*this;
+      return previous;
     }
 
     /**
@@ -127,7 +261,7 @@ public:
      */
     T& operator*() const
     {
-      throw std::logic_error("Not implemented yet");
+      return m_pTree->m_Nodes[m_Node].elements[m_Index];
     }
 
     T* operator->()
@@ -143,19 +277,163 @@ public:
    *
    * @param limits Les limites géométriques du QuadTree.
    */
-  TQuadTree(const SLimits& limits = { 0.0f,0.0f,1.0f,1.0f })
+  TQuadTree(const limits_type& limits = { 0.0f,0.0f,1.0f,1.0f })
+    : TQuadTree(limits, allocator_type())
+  {
+  }
+
+  /**
+   * @brief Constructeur de la classe TQuadTree avec un allocateur.
+   *
+   * Tous les noeuds et toutes les listes de données des noeuds sont alloués avec cet allocateur.
+   * Avec une ressource std::pmr::unsynchronized_pool_resource par exemple, un cycle clear() puis reconstruction
+   * réutilise la mémoire rendue au pool et n'alloue plus rien auprès du système une fois le régime établi.
+   *
+   * @param limits Les limites géométriques du QuadTree.
+   * @param allocator L'allocateur à utiliser.
+   */
+  TQuadTree(const limits_type& limits, const allocator_type& allocator)
+    : m_Nodes(node_allocator(allocator)), m_Locations(location_allocator(allocator)), m_FreeChildren(allocator)
+  {
+    m_Nodes.push_back(makeNode(limits, npos));
+  }
+
+  /**
+   * @brief Constructeur de la classe TQuadTree à partir d'une liste d'éléments.
+   *
+   * Les éléments sont chargés en une seule passe (voir assign), ce qui est bien plus rapide que de les insérer un à un.
+   *
+   * @param items Les éléments à stocker.
+   * @param limits Les limites géométriques du QuadTree.
+   * @param allocator L'allocateur à utiliser.
+   */
+  template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+  TQuadTree(R&& items, const limits_type& limits, const allocator_type& allocator = allocator_type())
+    : TQuadTree(limits, allocator)
+  {
+    assign(std::forward<R>(items));
+  }
+
+  /**
+   * @brief Constructeur de copie.
+   *
+   * Les noeuds, les éléments et les identifiants sont copiés : les identifiants de other désignent
+   * les mêmes éléments dans la copie. La copie utilise l'allocateur de other : celle d'un QuadTree placé
+   * dans une arène est placée dans la même arène (voir l'autre surcharge pour en choisir une autre).
+   */
+  TQuadTree(const TQuadTree& other)
+    : TQuadTree(other, other.get_allocator())
+  {
+  }
+
+  /**
+   * @brief Constructeur de copie avec un allocateur.
+   *
+   * Tous les noeuds et toutes les listes de données de la copie sont alloués avec cet allocateur (voir assignNodes).
+   *
+   * @param other Le QuadTree à copier.
+   * @param allocator L'allocateur à utiliser.
+   */
+  TQuadTree(const TQuadTree& other, const allocator_type& allocator)
+    : m_Nodes(node_allocator(allocator)), m_Locations(location_allocator(allocator)), m_FreeChildren(allocator)
+  {
+    assignNodes(other);
+  }
+
+  /**
+   * @brief Constructeur de déplacement.
+   *
+   * Le contenu de other est repris en temps constant, sans copie ni déplacement d'éléments et sans allocation.
+   * Les identifiants de other désignent leurs éléments dans ce QuadTree.
+   * other est laissé vide, avec les limites par défaut { 0, 0, 1, 1 } : sa racine n'est recréée qu'à la première insertion.
+   */
+  TQuadTree(TQuadTree&& other) noexcept
+    : m_Nodes(std::move(other.m_Nodes)), m_Locations(std::move(other.m_Locations)), m_FreeLocation(other.m_FreeLocation),
+      m_FreeChildren(std::move(other.m_FreeChildren)), m_Depth(other.m_Depth), m_DepthStale(other.m_DepthStale)
+  {
+    other.abandon();
+  }
+
+  /**
+   * @brief Opérateur d'affectation par copie.
+   *
+   * Ce QuadTree garde son allocateur : tous les noeuds et toutes les listes de données de la copie sont alloués avec lui.
+   */
+  TQuadTree& operator=(const TQuadTree& other)
+  {
+    if (this != &other)
+      assignNodes(other);
+    return *this;
+  }
+
+  /**
+   * @brief Opérateur d'affectation par déplacement.
+   *
+   * Si les deux QuadTree utilisent des allocateurs égaux, le contenu de other est repris en temps constant, sans allocation.
+   * Sinon, les éléments de other sont déplacés un à un dans des noeuds alloués avec l'allocateur de ce QuadTree.
+   * Dans les deux cas, other est laissé vide (voir le constructeur de déplacement).
+   */
+  TQuadTree& operator=(TQuadTree&& other) noexcept(std::allocator_traits<Allocator>::is_always_equal::value)
+  {
+    if (this == &other)
+      return *this;
+    if (get_allocator() == other.get_allocator())
+    {
+      m_Nodes = std::move(other.m_Nodes);
+      m_Locations = std::move(other.m_Locations);
+      m_FreeLocation = other.m_FreeLocation;
+      m_FreeChildren = std::move(other.m_FreeChildren);
+      m_Depth = other.m_Depth;
+      m_DepthStale = other.m_DepthStale;
+    }
+    else
+      assignNodes(std::move(other));
+    other.abandon();
+    return *this;
+  }
+
+  /**
+   * @brief Échange le contenu de deux QuadTree en temps constant, sans copie ni déplacement d'éléments.
+   *
+   * Comme pour les conteneurs standards, les deux QuadTree doivent utiliser des allocateurs égaux.
+   * Les identifiants suivent leurs éléments : ceux de other désignent ensuite des éléments de ce QuadTree, et inversement.
+   * Par exemple, deux QuadTree alternés d'une étape de simulation à l'autre sont échangés sans être recopiés.
+   */
+  void swap(TQuadTree& other) noexcept
+  {
+    using std::swap;
+    swap(m_Nodes, other.m_Nodes);
+    swap(m_Locations, other.m_Locations);
+    swap(m_FreeLocation, other.m_FreeLocation);
+    swap(m_FreeChildren, other.m_FreeChildren);
+    swap(m_Depth, other.m_Depth);
+    swap(m_DepthStale, other.m_DepthStale);
+  }
+
+  /**
+   * @brief Échange le contenu de deux QuadTree (voir la fonction membre swap).
+   */
+  friend void swap(TQuadTree& a, TQuadTree& b) noexcept
+  {
+    a.swap(b);
+  }
+
+  /**
+   * @brief Retourne l'allocateur utilisé par ce QuadTree.
+   */
+  allocator_type get_allocator() const
   {
-    //Evidemment, il va falloir compléter ce constructeur pour qu'il initialise correctement votre TQuadTree
+    return allocator_type(m_Nodes.get_allocator());
   }
 
 
   /**
    * @brief Retourne les limites géométriques de ce QuadTree
    */
-  SLimits limits() const
+  limits_type limits() const
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne les limites géométriques de ce QuadTree
-    return {};
+    return m_Nodes.empty() ? defaultLimits : m_Nodes[0].limits;
   }
 
   /**
@@ -167,19 +445,23 @@ public:
    */
   bool empty() const
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne true uniquement si le QuadTree est vide
-    return true;
+    return size() == 0;
   }
 
   /**
    * @brief Retourne la profondeur maximale du QuadTree.
    *
    * La profondeur maximale du QuadTree correspond nombre maximal de niveaux de descendants.
+   * Après des retraits, elle est recalculée au premier appel.
    */
   size_t depth() const
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne la profondeur maximale du QuadTree
-    return 0;
+    if (m_DepthStale)
+    {
+      m_Depth = sizesByLevel().size();
+      m_DepthStale = false;
+    }
+    return m_Depth;
   }
 
   /**
@@ -191,23 +473,160 @@ public:
    */
   size_t size() const
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne le nombre d'éléments stockés dans le QuadTree
-    return 0;
+    return m_Nodes.empty() ? 0 : m_Nodes[0].subtreeSize;
   }
 
   /**
    * @brief Insère un élément dans le QuadTree.
    *
    * Cette fonction insère un élément de données dans le QuadTree.
-   * Si l'élément est en dehors des limites du QuadTree, une exception de type std::domain_error est levée.
+   * Si l'élément est en dehors des limites du QuadTree, la racine est agrandie si la politique le permet (Policy::growable),
+   * sinon une exception de type std::domain_error est levée (voir tryInsert).
    * Si l'élément est dans les limites d'un enfant, il est inséré dans cet enfant.
    * Sinon, l'élément est ajouté à la liste des données du QuadTree.
    *
+   * La création des enfants et la profondeur atteinte dépendent de la politique Policy.
+   *
    * @param t L'élément à insérer dans le QuadTree.
    */
   void insert(const T& t)
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle insère l'élément dans le QuadTree
+    if (!tryInsert(t))
+      throw std::domain_error("TQuadTree::insert : l'élément est en dehors des limites du QuadTree");
+  }
+
+  /**
+   * @brief Insère un élément dans le QuadTree en le déplaçant plutôt qu'en le copiant (voir l'autre surcharge).
+   *
+   * Si l'élément est en dehors des limites du QuadTree, il n'est pas déplacé.
+   */
+  void insert(T&& t)
+  {
+    if (!tryInsert(std::move(t)))
+      throw std::domain_error("TQuadTree::insert : l'élément est en dehors des limites du QuadTree");
+  }
+
+  /**
+   * @brief Construit un élément à partir d'arguments et l'insère dans le QuadTree.
+   *
+   * Le noeud de l'élément dépendant de ses limites, l'élément est d'abord construit, puis déplacé dans ce noeud
+   * comme par insert(T&&) : il n'est jamais copié.
+   *
+   * @param args Les arguments du constructeur de l'élément.
+   */
+  template <typename... Args>
+    requires std::constructible_from<T, Args...>
+  void emplace(Args&&... args)
+  {
+    insert(T(std::forward<Args>(args)...));
+  }
+
+  /**
+   * @brief Insère un élément dans le QuadTree, sans lever d'exception s'il est en dehors de ses limites.
+   *
+   * Pour les flux de données dont l'étendue n'est pas connue à l'avance, où une exception par élément rejeté coûterait cher.
+   * Avec un QuadTree extensible (Policy::growable), seul un élément dont les limites ne sont pas finies est rejeté.
+   *
+   * @param t L'élément à insérer dans le QuadTree.
+   * @return false si l'élément est en dehors des limites du QuadTree (il n'est alors pas inséré), true sinon.
+   */
+  bool tryInsert(const T& t)
+  {
+    return add(t, nullptr);
+  }
+
+  /**
+   * @brief Insère un élément dans le QuadTree en le déplaçant, sans lever d'exception s'il est en dehors de ses limites.
+   *
+   * Un élément rejeté n'est pas déplacé : l'appelant le retrouve intact.
+   */
+  bool tryInsert(T&& t)
+  {
+    return add(std::move(t), nullptr);
+  }
+
+  /**
+   * @brief Insère un élément dans le QuadTree et retourne un identifiant stable de cet élément.
+   *
+   * L'élément est rangé comme par insert. L'identifiant permet ensuite de le retrouver (at), de le retirer (remove)
+   * ou de le remplacer (update) sans aucune recherche par égalité.
+   *
+   * @param t L'élément à insérer dans le QuadTree.
+   * @return L'identifiant de l'élément.
+   */
+  handle insertWithHandle(const T& t)
+  {
+    uint32_t id;
+    if (!add(t, &id))
+      throw std::domain_error("TQuadTree::insertWithHandle : l'élément est en dehors des limites du QuadTree");
+    return { id, m_Locations[id].generation };
+  }
+
+  /**
+   * @brief Insère un élément en le déplaçant et retourne un identifiant stable de cet élément (voir l'autre surcharge).
+   */
+  handle insertWithHandle(T&& t)
+  {
+    uint32_t id;
+    if (!add(std::move(t), &id))
+      throw std::domain_error("TQuadTree::insertWithHandle : l'élément est en dehors des limites du QuadTree");
+    return { id, m_Locations[id].generation };
+  }
+
+  /**
+   * @brief Vérifie si un identifiant désigne un élément présent dans le QuadTree.
+   */
+  bool contains(handle h) const
+  {
+    return locate(h) != nullptr;
+  }
+
+  /**
+   * @brief Retourne l'élément désigné par un identifiant.
+   *
+   * Si l'identifiant est invalide, une exception de type std::out_of_range est levée.
+   */
+  const T& at(handle h) const
+  {
+    const SLocation* pLocation = locate(h);
+    if (pLocation == nullptr)
+      throw std::out_of_range("TQuadTree::at : l'identifiant ne désigne aucun élément");
+    return m_Nodes[pLocation->node].elements[pLocation->slot];
+  }
+
+  /**
+   * @brief Remplace le contenu du QuadTree par une liste d'éléments.
+   *
+   * Plutôt que d'insérer les éléments un à un, le noeud de destination de chaque élément est d'abord calculé et
+   * les éléments de chaque noeud comptés. Les noeuds sont ensuite renumérotés en profondeur d'abord, c'est-à-dire
+   * dans l'ordre de Morton de leurs cellules, et chaque liste de données est allouée une seule fois à sa taille finale
+   * avant d'être remplie en un seul passage sur les éléments. On évite ainsi les réallocations successives
+   * des listes de données, et les noeuds d'un même sous-arbre sont voisins en mémoire pour les requêtes.
+   *
+   * Avec la politique par défaut, le QuadTree obtenu est identique à celui construit par des insertions successives,
+   * à l'ordre des éléments près. Avec une capacité de feuilles, une feuille est subdivisée dès qu'elle déborde,
+   * alors que la forme obtenue par insertions successives dépend de l'ordre d'insertion.
+   * Si un élément est en dehors des limites du QuadTree, la racine est agrandie pour tous les contenir si la politique
+   * le permet (Policy::growable). Sinon, une exception de type std::domain_error est levée et le QuadTree n'est pas modifié.
+   *
+   * @param items Les éléments à stocker.
+   */
+  template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+  void assign(R&& items)
+  {
+    if constexpr (std::ranges::random_access_range<R> && std::ranges::sized_range<R>
+      && std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<R>>, T>)
+      bulkLoad(items);
+    else
+    {
+      std::vector<T> elements;
+      if constexpr (std::ranges::sized_range<R>)
+        elements.reserve(std::ranges::size(items));
+      for (auto&& item : items)
+        elements.push_back(static_cast<T>(item));
+      bulkLoad(elements);
+    }
   }
 
   /**
@@ -217,12 +636,152 @@ public:
    */
   void clear()
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle vide le QuadTree
+    restoreRoot();
+    m_Nodes.resize(1);
+    m_Nodes[0].firstChild = npos;
+    m_Nodes[0].subtreeSize = 0;
+    m_Nodes[0].elements.clear();
+    m_Nodes[0].bounds.clear();
+    m_Nodes[0].handles.clear();
+    m_FreeChildren.clear();
+    for (uint32_t id = 0; id < m_Locations.size(); ++id)
+      if (m_Locations[id].slot != npos)
+        release(id);
+    m_Depth = 1;
+    m_DepthStale = false;
   }
 
+  /**
+   * @brief Retire un élément du QuadTree.
+   *
+   * Le noeud pouvant contenir l'élément est retrouvé directement à partir de ses limites,
+   * seule la liste des données de ce noeud est parcourue (puis celles de ses ancêtres,
+   * où un élément déplacé par relocate peut être resté).
+   * Si plusieurs éléments égaux sont présents, un seul d'entre eux est retiré.
+   * Si l'élément n'est pas présent, le QuadTree n'est pas modifié.
+   * Les enfants devenus (presque) vides sont ensuite fusionnés avec leur parent (voir collapse).
+   *
+   * @param t L'élément à retirer du QuadTree.
+   */
   void remove(const T& t)
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle retire l'élément du QuadTree
+    uint32_t node;
+    size_t slot;
+    if (!search(t, node, slot))
+      return;
+    release(m_Nodes[node].handles[slot]);
+    erase(node, slot);
+    collapse(node);
+  }
+
+  /**
+   * @brief Retire l'élément désigné par un identifiant.
+   *
+   * L'emplacement de l'élément est connu : aucune recherche n'est faite.
+   *
+   * @param h L'identifiant de l'élément à retirer.
+   * @return false si l'identifiant ne désigne aucun élément, true sinon.
+   */
+  bool remove(handle h)
+  {
+    const SLocation* pLocation = locate(h);
+    if (pLocation == nullptr)
+      return false;
+    const SLocation location = *pLocation;
+    release(h.id);
+    erase(location.node, location.slot);
+    collapse(location.node);
+    return true;
+  }
+
+  /**
+   * @brief Remplace l'élément désigné par un identifiant, par exemple après un déplacement.
+   *
+   * Si l'élément reste dans le même noeud, il est remplacé sur place.
+   * Sinon, il est retiré de son noeud sans recherche puis rangé à nouveau à partir de la racine.
+   * L'identifiant reste valide.
+   * Si le nouvel élément est en dehors des limites du QuadTree (et que la racine ne peut pas être agrandie),
+   * une exception de type std::domain_error est levée et le QuadTree n'est pas modifié.
+   *
+   * @param h L'identifiant de l'élément à remplacer.
+   * @param t Le nouvel élément.
+   * @return false si l'identifiant ne désigne aucun élément, true sinon.
+   */
+  bool update(handle h, const T& t)
+  {
+    return replace(h, t);
+  }
+
+  /**
+   * @brief Remplace l'élément désigné par un identifiant par un élément déplacé plutôt que copié (voir l'autre surcharge).
+   */
+  bool update(handle h, T&& t)
+  {
+    return replace(h, std::move(t));
+  }
+
+  /**
+   * @brief Déplace l'élément désigné par un identifiant, en modifiant le moins possible le QuadTree.
+   *
+   * Le nouvel élément est rangé selon ses limites agrandies de margin de chaque côté (sans sortir du QuadTree).
+   * Tant qu'il reste dans cette zone agrandie, l'élément est simplement remplacé sur place, sans aucune modification
+   * de structure : une marge de l'ordre de quelques déplacements suffit à ce que la plupart des déplacements d'objets
+   * animés ne coûtent qu'une copie.
+   * Sinon, on ne remonte depuis le noeud de l'élément que jusqu'au premier ancêtre contenant la zone agrandie,
+   * et on ne redescend que depuis cet ancêtre.
+   *
+   * Avec une marge, l'élément n'est donc pas forcément dans le noeud le plus profond qui le contient :
+   * les requêtes restent exactes, mais un tel élément doit être retiré par son identifiant.
+   * Sans marge, l'élément est rangé comme par une insertion et peut aussi être retiré par égalité.
+   * Si le nouvel élément est en dehors des limites du QuadTree (et que la racine ne peut pas être agrandie),
+   * une exception de type std::domain_error est levée et le QuadTree n'est pas modifié.
+   *
+   * @param h L'identifiant de l'élément à déplacer.
+   * @param t Le nouvel élément.
+   * @param margin La marge ajoutée autour des limites de l'élément lorsqu'il doit être rangé à nouveau.
+   * @return false si l'identifiant ne désigne aucun élément, true sinon.
+   */
+  bool relocate(handle h, const T& t, coordinate margin = 0.0f)
+  {
+    return reposition(h, t, margin);
+  }
+
+  /**
+   * @brief Déplace l'élément désigné par un identifiant, le nouvel élément étant déplacé plutôt que copié (voir l'autre surcharge).
+   */
+  bool relocate(handle h, T&& t, coordinate margin = 0.0f)
+  {
+    return reposition(h, std::move(t), margin);
+  }
+
+  /**
+   * @brief Remplace un élément par un autre, en modifiant le moins possible le QuadTree.
+   *
+   * L'élément est retrouvé comme par remove, puis déplacé comme par relocate (sans marge).
+   * Si le nouvel élément est en dehors des limites du QuadTree (et que la racine ne peut pas être agrandie),
+   * une exception de type std::domain_error est levée et le QuadTree n'est pas modifié.
+   *
+   * @param previous L'élément à remplacer.
+   * @param t Le nouvel élément.
+   * @return false si l'élément à remplacer n'est pas présent, true sinon.
+   */
+  bool relocate(const T& previous, const T& t)
+  {
+    if (m_Nodes.empty())
+      return false;
+    const limits_type bounds = boundsOf(t);
+    if (!admit(bounds))
+      throw std::domain_error("TQuadTree::relocate : l'élément est en dehors des limites du QuadTree");
+    uint32_t node;
+    size_t slot;
+    if (!search(previous, node, slot))
+      return false;
+
+    const uint32_t id = m_Nodes[node].handles[slot];
+    if (id != npos)
+      m_Locations[id].placement = bounds;
+    move(node, slot, bounds, t, id);
+    return true;
   }
 
 
@@ -236,8 +795,11 @@ public:
    */
   container getAll() const
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne tous les éléments stockés dans le QuadTree
-    return {};
+    container result;
+    result.reserve(size());
+    for (const SNode& node : m_Nodes)
+      result.insert(result.end(), node.elements.begin(), node.elements.end());
+    return result;
   }
 
   /**
@@ -249,10 +811,11 @@ public:
    * @param limits Les limites de la zone de recherche.
    * @return Une liste de tous les éléments trouvés dans la zone spécifiée.
    */
-  container findInscribed(const SLimits& limits) const
+  container findInscribed(const limits_type& limits) const
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne tous les éléments inclus dans la zone spécifiée
-    return {};
+    container result;
+    collect(EQuery::inscribed, limits, result);
+    return result;
   }
 
   /**
@@ -264,51 +827,1812 @@ public:
    * @param limits Les limites de la zone de recherche.
    * @return Une liste de tous les éléments trouvés dans la zone spécifiée.
    */
-  container findColliding(const SLimits& limits) const
+  container findColliding(const limits_type& limits) const
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne tous les éléments en collision avec la zone spécifiée
-    return {};
+    container result;
+    collect(EQuery::colliding, limits, result);
+    return result;
   }
 
   /**
-   * @brief Retourne un iterateur permettant de lister un à un tous les éléments
+   * @brief Copie tous les éléments stockés dans le QuadTree vers un itérateur de sortie.
+   *
+   * L'appelant choisit la destination, par exemple un std::back_inserter sur une liste réutilisée d'un appel à l'autre.
+   *
+   * @param out L'itérateur de sortie.
+   * @return L'itérateur de sortie après le dernier élément copié.
    */
-  iterator begin()
+  template <std::output_iterator<const T&> O>
+  O getAll(O out) const
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne un iterateur de début
-    return {};
+    for (const SNode& node : m_Nodes)
+      out = std::copy(node.elements.begin(), node.elements.end(), out);
+    return out;
   }
 
   /**
-   * @brief Retourne un iterateur permettant de lister un à un tous les éléments inclus dans les limites spécifiées
+   * @brief Ajoute à une liste l'adresse de tous les éléments stockés dans le QuadTree.
    *
-   * Les éléments listés sont ceux qui entrent en collision avec les limites spécifiées
+   * Aucun élément n'est copié, et la liste de l'appelant peut être réutilisée d'un appel à l'autre
+   * (elle n'est pas vidée) : une fois sa capacité établie, la requête n'alloue plus rien.
+   * Les adresses restent valides jusqu'à la prochaine modification du QuadTree.
+   *
+   * @param [in,out] result La liste à laquelle les adresses sont ajoutées.
    */
-  iterator beginColliding(const SLimits& limits)
+  void getAll(std::vector<const T*>& result) const
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne un iterateur de début
-    return {};
+    result.reserve(result.size() + size());
+    for (const SNode& node : m_Nodes)
+      for (const T& t : node.elements)
+        result.push_back(&t);
   }
 
   /**
-   * @brief Retourne un iterateur permettant de lister un à un tous les éléments inclus dans les limites spécifiées
+   * @brief Copie les éléments totalement inclus dans une zone spécifiée vers un itérateur de sortie.
    *
-   * Les éléments listés sont ceux qui sont inclus dans les limites spécifiées
+   * @param limits Les limites de la zone de recherche.
+   * @param out L'itérateur de sortie.
+   * @return L'itérateur de sortie après le dernier élément copié.
    */
-  iterator beginInscribed(const SLimits& limits)
+  template <std::output_iterator<const T&> O>
+  O findInscribed(const limits_type& limits, O out) const
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne un iterateur de début
-    return {};
+    auto copy = [&out](const T& t) { *out++ = t; };
+    auto copyAll = [&out](const bucket& elements) { out = std::copy(elements.begin(), elements.end(), out); return true; };
+    visit(EQuery::inscribed, limits, copy, copyAll);
+    return out;
   }
 
   /**
-   * @brief Retourne un iterateur de fin
+   * @brief Ajoute à une liste l'adresse des éléments totalement inclus dans une zone spécifiée.
+   *
+   * Aucun élément n'est copié et la liste n'est pas vidée (voir getAll).
+   * Les adresses restent valides jusqu'à la prochaine modification du QuadTree.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @param [in,out] result La liste à laquelle les adresses sont ajoutées.
    */
-  iterator end()
+  void findInscribed(const limits_type& limits, std::vector<const T*>& result) const
   {
-    //Evidemment, il va falloir compléter cette fonction pour qu'elle retourne un iterateur de fin
-    return {};
+    collect(EQuery::inscribed, limits, result);
   }
 
-};
+  /**
+   * @brief Copie les éléments en collision avec une zone spécifiée vers un itérateur de sortie.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @param out L'itérateur de sortie.
+   * @return L'itérateur de sortie après le dernier élément copié.
+   */
+  template <std::output_iterator<const T&> O>
+  O findColliding(const limits_type& limits, O out) const
+  {
+    auto copy = [&out](const T& t) { *out++ = t; };
+    auto copyAll = [&out](const bucket& elements) { out = std::copy(elements.begin(), elements.end(), out); return true; };
+    visit(EQuery::colliding, limits, copy, copyAll);
+    return out;
+  }
+
+  /**
+   * @brief Ajoute à une liste l'adresse des éléments en collision avec une zone spécifiée.
+   *
+   * Aucun élément n'est copié et la liste n'est pas vidée (voir getAll).
+   * Les adresses restent valides jusqu'à la prochaine modification du QuadTree.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @param [in,out] result La liste à laquelle les adresses sont ajoutées.
+   */
+  void findColliding(const limits_type& limits, std::vector<const T*>& result) const
+  {
+    collect(EQuery::colliding, limits, result);
+  }
+
+  /**
+   * @brief Appelle une fonction pour chaque élément totalement inclus dans une zone spécifiée.
+   *
+   * Contrairement à findInscribed, aucune liste n'est construite : la requête n'alloue rien.
+   * Si la fonction retourne un booléen, le parcours s'arrête dès qu'elle retourne false.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @param f La fonction appelée avec chaque élément trouvé (const T&).
+   * @return false si le parcours a été interrompu par la fonction, true sinon.
+   */
+  template <typename F>
+    requires std::invocable<F&, const T&>
+  bool forEachInscribed(const limits_type& limits, F&& f) const
+  {
+    return visit(EQuery::inscribed, limits, f);
+  }
+
+  /**
+   * @brief Appelle une fonction pour chaque élément en collision avec une zone spécifiée.
+   *
+   * Contrairement à findColliding, aucune liste n'est construite : la requête n'alloue rien.
+   * Si la fonction retourne un booléen, le parcours s'arrête dès qu'elle retourne false.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @param f La fonction appelée avec chaque élément trouvé (const T&).
+   * @return false si le parcours a été interrompu par la fonction, true sinon.
+   */
+  template <typename F>
+    requires std::invocable<F&, const T&>
+  bool forEachColliding(const limits_type& limits, F&& f) const
+  {
+    return visit(EQuery::colliding, limits, f);
+  }
+
+  /**
+   * @brief Trouve les éléments totalement inclus dans une forme : un disque, un polygone convexe (voir QueryShape).
+   *
+   * Seuls les noeuds dont la cellule agrandie touche la forme sont visités, et ceux dont la cellule agrandie y est incluse
+   * sont retenus d'un bloc. Les autres éléments sont d'abord filtrés sur le rectangle englobant de la forme, puis testés
+   * exactement : le résultat ne contient que les éléments de la forme, sans filtrage à faire par l'appelant.
+   *
+   * @param shape La forme de la zone de recherche, par exemple un circle_type ou un polygon_type.
+   * @return Une liste de tous les éléments trouvés dans la forme.
+   */
+  template <QueryShape<limits_type> S>
+  container findInscribed(const S& shape) const
+  {
+    container result;
+    collectShape(EQuery::inscribed, shape, result);
+    return result;
+  }
+
+  /**
+   * @brief Trouve les éléments en collision avec une forme (voir findInscribed).
+   *
+   * @param shape La forme de la zone de recherche, par exemple un circle_type ou un polygon_type.
+   * @return Une liste de tous les éléments en collision avec la forme.
+   */
+  template <QueryShape<limits_type> S>
+  container findColliding(const S& shape) const
+  {
+    container result;
+    collectShape(EQuery::colliding, shape, result);
+    return result;
+  }
+
+  /**
+   * @brief Ajoute à une liste l'adresse des éléments totalement inclus dans une forme (voir findInscribed).
+   *
+   * Aucun élément n'est copié et la liste n'est pas vidée (voir getAll).
+   * Les adresses restent valides jusqu'à la prochaine modification du QuadTree.
+   *
+   * @param shape La forme de la zone de recherche.
+   * @param [in,out] result La liste à laquelle les adresses sont ajoutées.
+   */
+  template <QueryShape<limits_type> S>
+  void findInscribed(const S& shape, std::vector<const T*>& result) const
+  {
+    collectShape(EQuery::inscribed, shape, result);
+  }
+
+  /**
+   * @brief Ajoute à une liste l'adresse des éléments en collision avec une forme (voir findInscribed).
+   *
+   * @param shape La forme de la zone de recherche.
+   * @param [in,out] result La liste à laquelle les adresses sont ajoutées.
+   */
+  template <QueryShape<limits_type> S>
+  void findColliding(const S& shape, std::vector<const T*>& result) const
+  {
+    collectShape(EQuery::colliding, shape, result);
+  }
+
+  /**
+   * @brief Appelle une fonction pour chaque élément totalement inclus dans une forme (voir findInscribed et forEachInscribed).
+   *
+   * @param shape La forme de la zone de recherche.
+   * @param f La fonction appelée avec chaque élément trouvé (const T&).
+   * @return false si le parcours a été interrompu par la fonction, true sinon.
+   */
+  template <QueryShape<limits_type> S, typename F>
+    requires std::invocable<F&, const T&>
+  bool forEachInscribed(const S& shape, F&& f) const
+  {
+    auto each = [&f](const bucket& elements) { return std::ranges::all_of(elements, [&f](const T& t) { return call(f, t); }); };
+    return visitShape(EQuery::inscribed, shape, f, each);
+  }
+
+  /**
+   * @brief Appelle une fonction pour chaque élément en collision avec une forme (voir findInscribed et forEachColliding).
+   *
+   * @param shape La forme de la zone de recherche.
+   * @param f La fonction appelée avec chaque élément trouvé (const T&).
+   * @return false si le parcours a été interrompu par la fonction, true sinon.
+   */
+  template <QueryShape<limits_type> S, typename F>
+    requires std::invocable<F&, const T&>
+  bool forEachColliding(const S& shape, F&& f) const
+  {
+    auto each = [&f](const bucket& elements) { return std::ranges::all_of(elements, [&f](const T& t) { return call(f, t); }); };
+    return visitShape(EQuery::colliding, shape, f, each);
+  }
+
+  /**
+   * @brief Trouve les éléments qui contiennent un point (bords inclus).
+   *
+   * Seul le chemin des cellules contenant le point est parcouru, au lieu de tous les noeuds en collision avec une zone :
+   * c'est la requête d'un pointage à la souris.
+   *
+   * @param x La coordonnée x du point.
+   * @param y La coordonnée y du point.
+   * @return Une liste de tous les éléments contenant le point.
+   */
+  container findContaining(coordinate x, coordinate y) const
+  {
+    container result;
+    auto add = [&result](const T& t) { result.push_back(t); };
+    visitContaining(0, { x, y, x, y }, add);
+    return result;
+  }
+
+  /**
+   * @brief Ajoute à une liste l'adresse des éléments qui contiennent un point (voir findContaining).
+   *
+   * Aucun élément n'est copié et la liste n'est pas vidée (voir getAll).
+   * Les adresses restent valides jusqu'à la prochaine modification du QuadTree.
+   *
+   * @param x La coordonnée x du point.
+   * @param y La coordonnée y du point.
+   * @param [in,out] result La liste à laquelle les adresses sont ajoutées.
+   */
+  void findContaining(coordinate x, coordinate y, std::vector<const T*>& result) const
+  {
+    auto add = [&result](const T& t) { result.push_back(&t); };
+    visitContaining(0, { x, y, x, y }, add);
+  }
+
+  /**
+   * @brief Appelle une fonction pour chaque élément qui contient un point (voir findContaining).
+   *
+   * Aucune liste n'est construite : la requête n'alloue rien.
+   * Si la fonction retourne un booléen, le parcours s'arrête dès qu'elle retourne false.
+   *
+   * @param x La coordonnée x du point.
+   * @param y La coordonnée y du point.
+   * @param f La fonction appelée avec chaque élément trouvé (const T&).
+   * @return false si le parcours a été interrompu par la fonction, true sinon.
+   */
+  template <typename F>
+    requires std::invocable<F&, const T&>
+  bool forEachContaining(coordinate x, coordinate y, F&& f) const
+  {
+    return visitContaining(0, { x, y, x, y }, f);
+  }
+
+  /**
+   * @brief Trouve les k éléments les plus proches d'un point.
+   *
+   * Les noeuds sont visités du plus proche au plus éloigné du point (parcours "best-first") : dès que le noeud suivant
+   * est plus loin que le k-ième élément trouvé, tous les autres le sont aussi et le parcours s'arrête.
+   * Seuls les noeuds voisins du point sont donc lus, quelle que soit la taille du QuadTree.
+   *
+   * @param x La coordonnée x du point.
+   * @param y La coordonnée y du point.
+   * @param k Le nombre d'éléments voulus.
+   * @param metric La distance d'un point à un élément (voir SBoxDistance et SCentroidDistance).
+   * @return Les k éléments les plus proches (ou tous s'il y en a moins), du plus proche au plus éloigné.
+   */
+  template <typename Metric = SBoxDistance>
+  container findNearest(coordinate x, coordinate y, size_t k, const Metric& metric = Metric()) const
+  {
+    const auto nearest = findNearestCandidates(x, y, k, metric);
+    container result;
+    result.reserve(nearest.size());
+    for (const auto& candidate : nearest)
+      result.push_back(*candidate.second);
+    return result;
+  }
+
+  /**
+   * @brief Ajoute à une liste l'adresse des k éléments les plus proches d'un point (voir findNearest).
+   *
+   * Aucun élément n'est copié et la liste n'est pas vidée (voir getAll).
+   * Les adresses restent valides jusqu'à la prochaine modification du QuadTree.
+   *
+   * @param x La coordonnée x du point.
+   * @param y La coordonnée y du point.
+   * @param k Le nombre d'éléments voulus.
+   * @param [in,out] result La liste à laquelle les adresses sont ajoutées, du plus proche au plus éloigné.
+   * @param metric La distance d'un point à un élément (voir SBoxDistance et SCentroidDistance).
+   */
+  template <typename Metric = SBoxDistance>
+  void findNearest(coordinate x, coordinate y, size_t k, std::vector<const T*>& result, const Metric& metric = Metric()) const
+  {
+    for (const auto& candidate : findNearestCandidates(x, y, k, metric))
+      result.push_back(candidate.second);
+  }
+
+  /**
+   * @brief Compte les éléments totalement inclus dans une zone spécifiée, sans les copier.
+   *
+   * Un noeud dont la cellule est totalement incluse dans la zone est compté d'un bloc avec toute sa descendance,
+   * sans que ses éléments soient lus : le coût dépend du bord de la zone, pas du nombre d'éléments qu'elle contient.
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @return Le nombre d'éléments que findInscribed retournerait.
+   */
+  size_t countInscribed(const limits_type& limits) const
+  {
+    return countMatches(EQuery::inscribed, limits);
+  }
+
+  /**
+   * @brief Compte les éléments en collision avec une zone spécifiée, sans les copier (voir countInscribed).
+   *
+   * @param limits Les limites de la zone de recherche.
+   * @return Le nombre d'éléments que findColliding retournerait.
+   */
+  size_t countColliding(const limits_type& limits) const
+  {
+    return countMatches(EQuery::colliding, limits);
+  }
+
+  /**
+   * @brief Compte les éléments totalement inclus dans une forme, sans les copier (voir findInscribed et countInscribed).
+   *
+   * @param shape La forme de la zone de recherche.
+   * @return Le nombre d'éléments que findInscribed retournerait.
+   */
+  template <QueryShape<limits_type> S>
+  size_t countInscribed(const S& shape) const
+  {
+    return countShape(EQuery::inscribed, shape);
+  }
+
+  /**
+   * @brief Compte les éléments en collision avec une forme, sans les copier (voir findInscribed et countInscribed).
+   *
+   * @param shape La forme de la zone de recherche.
+   * @return Le nombre d'éléments que findColliding retournerait.
+   */
+  template <QueryShape<limits_type> S>
+  size_t countColliding(const S& shape) const
+  {
+    return countShape(EQuery::colliding, shape);
+  }
+
+  /**
+   * @brief Retourne la répartition des éléments par niveau.
+   *
+   * @return Un tableau de depth() valeurs : l'index 0 donne le nombre d'éléments stockés à la racine,
+   * l'index 1 celui de ses enfants, etc.
+   */
+  std::vector<size_t> sizesByLevel() const
+  {
+    //Les groupes d'enfants libérés par collapse pouvant être réutilisés, un enfant peut précéder son parent dans m_Nodes :
+    //les niveaux sont donc obtenus par un parcours depuis la racine
+    std::vector<size_t> sizes(1);
+    if (m_Nodes.empty())
+      return sizes;
+    std::vector<std::pair<uint32_t, size_t>> pending{ { 0, 0 } };
+    while (!pending.empty())
+    {
+      const auto [node, level] = pending.back();
+      pending.pop_back();
+      if (level >= sizes.size())
+        sizes.resize(level + 1);
+      sizes[level] += m_Nodes[node].elements.size();
+      if (const uint32_t firstChild = m_Nodes[node].firstChild; firstChild != npos)
+        for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+          pending.push_back({ firstChild + quadrant, level + 1 });
+    }
+    while (sizes.size() > 1 && sizes.back() == 0)
+      sizes.pop_back();
+    return sizes;
+  }
+
+  /**
+   * @brief Retourne un iterateur permettant de lister un à un tous les éléments
+   */
+  iterator begin()
+  {
+    return iterator(this, EQuery::all, {});
+  }
+
+  /**
+   * @brief Retourne un iterateur permettant de lister un à un tous les éléments inclus dans les limites spécifiées
+   *
+   * Les éléments listés sont ceux qui entrent en collision avec les limites spécifiées
+   */
+  iterator beginColliding(const limits_type& limits)
+  {
+    return iterator(this, EQuery::colliding, limits);
+  }
+
+  /**
+   * @brief Retourne un iterateur permettant de lister un à un tous les éléments inclus dans les limites spécifiées
+   *
+   * Les éléments listés sont ceux qui sont inclus dans les limites spécifiées
+   */
+  iterator beginInscribed(const limits_type& limits)
+  {
+    return iterator(this, EQuery::inscribed, limits);
+  }
+
+  /**
+   * @brief Retourne un iterateur de fin
+   */
+  iterator end()
+  {
+    return {};
+  }
+
+private:
+  /**
+   * @brief Noeud du QuadTree.
+   *
+   * Les noeuds sont stockés de façon contiguë dans m_Nodes, la racine à l'index 0.
+   * Les quatre enfants d'un noeud sont alloués ensemble et se suivent dans le tableau (NO, NE, SO, SE) :
+   * ils sont adressés par le seul index du premier d'entre eux.
+   *
+   * Les limites des éléments sont recopiées dans bounds : les requêtes ne lisent que ces coordonnées contiguës
+   * et ne touchent aux éléments eux-mêmes que pour ceux qui les satisfont.
+   */
+  struct SNode
+  {
+    limits_type limits;  ///< Limites géométriques du noeud
+    uint32_t firstChild; ///< Index du premier des quatre enfants, npos si le noeud n'a pas d'enfant
+    uint32_t parent;     ///< Index du parent, npos pour la racine
+    size_t subtreeSize;  ///< Nombre d'éléments stockés dans le noeud et toute sa descendance
+    bucket elements;     ///< Éléments stockés dans ce noeud
+    bounds_array bounds; ///< Limites des éléments stockés dans ce noeud, dans le même ordre
+    index_list handles; ///< Identifiants des éléments stockés dans ce noeud, npos pour un élément inséré sans identifiant
+  };
+
+  /**
+   * @brief Emplacement d'un élément désigné par un identifiant.
+   *
+   * Un emplacement libre a un slot égal à npos, son champ node chaîne alors les emplacements libres.
+   */
+  struct SLocation
+  {
+    uint32_t node;       ///< Index du noeud de l'élément, ou prochain emplacement libre
+    uint32_t slot;       ///< Index de l'élément dans la liste des données du noeud, npos si l'emplacement est libre
+    uint32_t generation; ///< Nombre de libérations de l'emplacement, pour reconnaître les identifiants périmés
+    limits_type placement; ///< Zone selon laquelle l'élément est rangé : ses limites, agrandies de la marge de relocate
+  };
+
+  using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<SNode>;
+  using node_array = std::vector<SNode, node_allocator>;
+  using location_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<SLocation>;
+
+  node_array m_Nodes; ///< Noeuds du QuadTree, la racine est à l'index 0
+  std::vector<SLocation, location_allocator> m_Locations; ///< Emplacements des éléments ayant un identifiant
+  uint32_t m_FreeLocation = npos; ///< Premier emplacement libre de m_Locations
+  index_list m_FreeChildren;  ///< Premier index des groupes de quatre noeuds libérés par collapse, réutilisés par createChildren
+  mutable size_t m_Depth = 1; ///< Profondeur maximale du QuadTree, exacte si m_DepthStale est faux
+  mutable bool m_DepthStale = false; ///< Vrai si des éléments ont été retirés depuis le dernier calcul de m_Depth
+
+  /// Nombre d'éléments jusqu'auquel les enfants d'un noeud sont fusionnés avec lui (voir collapse).
+  static constexpr size_t mergeCapacity = Policy::bucketCapacity / 2;
+
+  /// Limites d'un QuadTree dont le contenu a été déplacé, celles du constructeur par défaut.
+  static constexpr limits_type defaultLimits{ 0.0f, 0.0f, 1.0f, 1.0f };
+
+  /**
+   * @brief Retourne les limites géométriques d'un élément.
+   */
+  static limits_type boundsOf(const T& t)
+  {
+    return { static_cast<coordinate>(t.x1()), static_cast<coordinate>(t.y1()), static_cast<coordinate>(t.x2()), static_cast<coordinate>(t.y2()) };
+  }
+
+  /**
+   * @brief Retourne le rectangle englobant d'une forme de requête (voir QueryShape).
+   */
+  template <typename S>
+  static limits_type boundsOf(const S& shape)
+  {
+    return { static_cast<coordinate>(shape.x1()), static_cast<coordinate>(shape.y1()), static_cast<coordinate>(shape.x2()), static_cast<coordinate>(shape.y2()) };
+  }
+
+  /**
+   * @brief Vérifie si deux zones sont en collision (bords inclus).
+   */
+  static bool isColliding(const limits_type& a, const limits_type& b)
+  {
+    return a.x1 <= b.x2 && a.x2 >= b.x1 && a.y1 <= b.y2 && a.y2 >= b.y1;
+  }
+
+  /**
+   * @brief Vérifie si la zone inner est totalement incluse dans la zone outer (bords inclus).
+   */
+  static bool isInscribed(const limits_type& inner, const limits_type& outer)
+  {
+    return inner.x1 >= outer.x1 && inner.x2 <= outer.x2 && inner.y1 >= outer.y1 && inner.y2 <= outer.y2;
+  }
+
+  /**
+   * @brief Vérifie que les coordonnées d'une zone sont finies (ni infinies, ni NaN).
+   */
+  static bool isFinite(const limits_type& bounds)
+  {
+    return std::isfinite(bounds.x1) && std::isfinite(bounds.y1) && std::isfinite(bounds.x2) && std::isfinite(bounds.y2);
+  }
+
+  /**
+   * @brief Convertit une zone en limites stockées dans le tableau des limites d'un noeud de limites cell.
+   *
+   * Sans compression, ce sont les limites elles-mêmes. Avec compression (voir SQuadTreePolicy::quantized), ce sont
+   * des positions sur une grille de 65535 pas couvrant la cellule agrandie du noeud, bornées à la grille et arrondies
+   * vers l'extérieur : x1 et y1 vers le bas, x2 et y2 vers le haut. La conversion étant croissante, une collision
+   * ou une inclusion entre une zone et les limites d'un élément l'est aussi entre leurs limites stockées.
+   */
+  static TLimits<stored_coordinate> storedLimits(const limits_type& cell, const limits_type& bounds)
+  {
+    if constexpr (!Policy::quantized)
+      return { bounds.x1, bounds.y1, bounds.x2, bounds.y2 };
+    else
+    {
+      constexpr coordinate steps = std::numeric_limits<uint16_t>::max();
+      const limits_type loose = looseLimits(cell);
+      //Une cellule sans étendue (précision atteinte) range tous ses éléments à 0 : ils sont tous retenus puis vérifiés
+      const coordinate scaleX = loose.x2 > loose.x1 ? steps / (loose.x2 - loose.x1) : 0;
+      const coordinate scaleY = loose.y2 > loose.y1 ? steps / (loose.y2 - loose.y1) : 0;
+      auto quantize = [](coordinate position) -> uint16_t
+      {
+        //Bornée à la grille, une position NaN (requête invalide) valant 0
+        return position > 0 ? static_cast<uint16_t>(std::min<coordinate>(position, std::numeric_limits<uint16_t>::max())) : 0;
+      };
+      return { quantize(std::floor((bounds.x1 - loose.x1) * scaleX)), quantize(std::floor((bounds.y1 - loose.y1) * scaleY)),
+               quantize(std::ceil((bounds.x2 - loose.x1) * scaleX)), quantize(std::ceil((bounds.y2 - loose.y1) * scaleY)) };
+    }
+  }
+
+  /**
+   * @brief Remplace les limites d'un élément d'un noeud.
+   */
+  static void setBounds(SNode& node, size_t slot, const limits_type& bounds)
+  {
+    const auto stored = storedLimits(node.limits, bounds);
+    node.bounds.set(slot, stored.x1, stored.y1, stored.x2, stored.y2);
+  }
+
+  /**
+   * @brief Calcule les masques des éléments de blocs consécutifs d'un noeud qui satisfont une requête.
+   *
+   * Avec des limites compressées, le test des blocs retient des éléments en trop : ils sont écartés sur leurs limites exactes.
+   *
+   * @param node Le noeud.
+   * @param first Le premier bloc.
+   * @param count Le nombre de blocs.
+   * @param [out] masks Le masque de chaque bloc.
+   */
+  static void matchMasks(const SNode& node, size_t first, size_t count, EQuery query, const limits_type& limits, unsigned* masks)
+  {
+    if (query == EQuery::all)
+    {
+      for (size_t block = 0; block < count; ++block)
+        masks[block] = node.bounds.usedMask(first + block);
+      return;
+    }
+
+    const auto stored = storedLimits(node.limits, limits);
+    if (query == EQuery::colliding)
+      node.bounds.collidingMasks(first, count, stored.x1, stored.y1, stored.x2, stored.y2, masks);
+    else
+      node.bounds.inscribedMasks(first, count, stored.x1, stored.y1, stored.x2, stored.y2, masks);
+    if constexpr (Policy::quantized)
+      for (size_t block = 0; block < count; ++block)
+        for (unsigned candidates = masks[block]; candidates != 0; candidates &= candidates - 1)
+        {
+          const unsigned lane = std::countr_zero(candidates);
+          const limits_type bounds = boundsOf(node.elements[(first + block) * bounds_array::width + lane]);
+          if (query == EQuery::colliding ? !isColliding(bounds, limits) : !isInscribed(bounds, limits))
+            masks[block] &= ~(1u << lane);
+        }
+  }
+
+  /**
+   * @brief Retourne les limites géométriques d'un quadrant d'une cellule.
+   *
+   * @param cell Les limites de la cellule.
+   * @param quadrant L'index du quadrant : bit 0 pour la moitié est, bit 1 pour la moitié sud.
+   */
+  static limits_type quadrantLimits(const limits_type& cell, uint32_t quadrant)
+  {
+    const coordinate midX = (cell.x1 + cell.x2) / 2.0f;
+    const coordinate midY = (cell.y1 + cell.y2) / 2.0f;
+    return { (quadrant & 1) ? midX : cell.x1, (quadrant & 2) ? midY : cell.y1,
+             (quadrant & 1) ? cell.x2 : midX, (quadrant & 2) ? cell.y2 : midY };
+  }
+
+  /**
+   * @brief Retourne la zone dans laquelle doivent tenir les éléments d'un noeud de limites cell.
+   *
+   * C'est la cellule agrandie de Policy::looseness autour de son centre, ou la cellule elle-même par défaut.
+   */
+  static limits_type looseLimits(const limits_type& cell)
+  {
+    if constexpr (Policy::looseness == 1.0f)
+      return cell;
+    else
+    {
+      const coordinate marginX = (cell.x2 - cell.x1) * ((Policy::looseness - 1.0f) / 2.0f);
+      const coordinate marginY = (cell.y2 - cell.y1) * ((Policy::looseness - 1.0f) / 2.0f);
+      return { cell.x1 - marginX, cell.y1 - marginY, cell.x2 + marginX, cell.y2 + marginY };
+    }
+  }
+
+  /**
+   * @brief Retourne le quadrant d'une cellule qui contient totalement une zone.
+   *
+   * Le quadrant candidat est celui qui contient le coin supérieur gauche de la zone,
+   * ou son centre pour un QuadTree lâche. La zone doit tenir dans les limites agrandies de ce quadrant (voir looseLimits).
+   *
+   * Le calcul est fait sans branchement : le quadrant choisi à chaque niveau est imprévisible
+   * et les erreurs de prédiction coûteraient plus cher que le calcul lui-même.
+   *
+   * @param cell Les limites de la cellule.
+   * @param bounds Les limites de la zone.
+   * @param [out] child Les limites du quadrant candidat.
+   * @return L'index du quadrant, ou npos si la zone ne tient dans aucun quadrant.
+   */
+  static uint32_t quadrantOf(const limits_type& cell, const limits_type& bounds, limits_type& child)
+  {
+    const coordinate midX = (cell.x1 + cell.x2) / 2.0f;
+    const coordinate midY = (cell.y1 + cell.y2) / 2.0f;
+    uint32_t east, south;
+    if constexpr (Policy::looseness == 1.0f)
+    {
+      east = bounds.x1 >= midX;
+      south = bounds.y1 >= midY;
+    }
+    else
+    {
+      east = (bounds.x1 + bounds.x2) / 2.0f >= midX;
+      south = (bounds.y1 + bounds.y2) / 2.0f >= midY;
+    }
+    const coordinate xs[3] = { cell.x1, midX, cell.x2 };
+    const coordinate ys[3] = { cell.y1, midY, cell.y2 };
+    child = { xs[east], ys[south], xs[east + 1], ys[south + 1] };
+    const limits_type loose = looseLimits(child);
+    //Une cellule qui ne peut plus être subdivisée (précision des coordonnées atteinte) garde ses éléments
+    const bool fits = (bounds.x1 >= loose.x1) & (bounds.x2 <= loose.x2) & (bounds.y1 >= loose.y1) & (bounds.y2 <= loose.y2)
+      & !(child == cell);
+    return fits ? (east | south << 1) : npos;
+  }
+
+  /**
+   * @brief Retourne le quadrant d'une cellule qui contient totalement une zone (voir l'autre surcharge).
+   */
+  static uint32_t quadrantOf(const limits_type& cell, const limits_type& bounds)
+  {
+    limits_type child;
+    return quadrantOf(cell, bounds, child);
+  }
+
+  /**
+   * @brief Laisse vide un QuadTree dont le contenu vient d'être repris par déplacement, sans rien allouer.
+   *
+   * Il n'a plus de racine : elle est recréée par restoreRoot avant toute modification, et les requêtes n'y trouvent rien.
+   */
+  void abandon() noexcept
+  {
+    m_Nodes.clear();
+    m_Locations.clear();
+    m_FreeLocation = npos;
+    m_FreeChildren.clear();
+    m_Depth = 1;
+    m_DepthStale = false;
+  }
+
+  /**
+   * @brief Recrée la racine d'un QuadTree laissé vide par un déplacement (voir abandon).
+   */
+  void restoreRoot()
+  {
+    if (m_Nodes.empty())
+      m_Nodes.push_back(makeNode(defaultLimits, npos));
+  }
+
+  /**
+   * @brief Remplace le contenu de ce QuadTree par celui de other, en allouant tout avec l'allocateur de ce QuadTree.
+   *
+   * Les noeuds sont reconstruits un à un (voir makeNode) puis leurs listes sont affectées, ce qui garde l'allocateur
+   * de la destination : copier un SNode construirait ses listes avec l'allocateur choisi par select_on_container_copy_construction,
+   * la ressource par défaut pour un std::pmr::polymorphic_allocator, hors de l'arène du QuadTree.
+   * Si other est une rvalue, ses éléments sont déplacés plutôt que copiés. Le contenu n'est remplacé qu'une fois
+   * tous les noeuds construits : en cas d'exception, ce QuadTree n'est pas modifié.
+   */
+  template <typename Other>
+  void assignNodes(Other&& other)
+  {
+    node_array nodes(m_Nodes.get_allocator());
+    nodes.reserve(other.m_Nodes.size());
+    for (auto& source : other.m_Nodes)
+    {
+      SNode& node = nodes.emplace_back(makeNode(source.limits, source.parent));
+      node.firstChild = source.firstChild;
+      node.subtreeSize = source.subtreeSize;
+      if constexpr (std::is_lvalue_reference_v<Other>)
+        node.elements = source.elements;
+      else
+        node.elements = std::move(source.elements);
+      node.bounds = source.bounds;
+      node.handles = source.handles;
+    }
+    decltype(m_Locations) locations(other.m_Locations.begin(), other.m_Locations.end(), m_Locations.get_allocator());
+    index_list freeChildren(other.m_FreeChildren.begin(), other.m_FreeChildren.end(), m_FreeChildren.get_allocator());
+
+    m_Nodes.swap(nodes);
+    m_Locations.swap(locations);
+    m_FreeChildren.swap(freeChildren);
+    m_FreeLocation = other.m_FreeLocation;
+    m_Depth = other.m_Depth;
+    m_DepthStale = other.m_DepthStale;
+  }
+
+  /**
+   * @brief Construit un noeud vide dont la liste de données utilise l'allocateur du QuadTree.
+   */
+  SNode makeNode(const limits_type& limits, uint32_t parent) const
+  {
+    return SNode{ limits, npos, parent, 0, bucket(m_Nodes.get_allocator()), bounds_array(m_Nodes.get_allocator()),
+                  index_list(m_Nodes.get_allocator()) };
+  }
+
+  /**
+   * @brief Ajoute un élément et ses limites à la liste des données d'un noeud.
+   *
+   * @param node Le noeud.
+   * @param t L'élément.
+   * @param id L'identifiant de l'élément, npos s'il n'en a pas.
+   */
+  template <typename U>
+  void append(uint32_t node, U&& t, uint32_t id)
+  {
+    SNode& current = m_Nodes[node];
+    const limits_type bounds = boundsOf(t);
+    if (id != npos)
+    {
+      m_Locations[id].node = node;
+      m_Locations[id].slot = static_cast<uint32_t>(current.elements.size());
+    }
+    const auto stored = storedLimits(current.limits, bounds);
+    current.bounds.push_back(stored.x1, stored.y1, stored.x2, stored.y2);
+    current.elements.push_back(std::forward<U>(t));
+    current.handles.push_back(id);
+  }
+
+  /**
+   * @brief Retire un élément de la liste des données d'un noeud en le remplaçant par le dernier.
+   *
+   * L'élément quitte le QuadTree : il est décompté du noeud et de tous ses ancêtres.
+   * L'identifiant de l'élément retiré n'est pas libéré (voir release).
+   *
+   * @param node Le noeud.
+   * @param slot L'index de l'élément dans la liste des données du noeud.
+   */
+  void erase(uint32_t node, size_t slot)
+  {
+    SNode& current = m_Nodes[node];
+    if (slot != current.elements.size() - 1)
+    {
+      current.elements[slot] = std::move(current.elements.back());
+      current.handles[slot] = current.handles.back();
+      if (current.handles[slot] != npos)
+        m_Locations[current.handles[slot]].slot = static_cast<uint32_t>(slot);
+    }
+    current.elements.pop_back();
+    current.handles.pop_back();
+    current.bounds.erase(slot);
+    for (; node != npos; node = m_Nodes[node].parent)
+      --m_Nodes[node].subtreeSize;
+    m_DepthStale = true;
+  }
+
+  /**
+   * @brief Réserve un emplacement pour un nouvel identifiant, en réutilisant un emplacement libre s'il y en a un.
+   */
+  uint32_t acquire()
+  {
+    if (m_FreeLocation == npos)
+    {
+      m_Locations.push_back({ npos, npos, 0, {} });
+      return static_cast<uint32_t>(m_Locations.size() - 1);
+    }
+    const uint32_t id = m_FreeLocation;
+    m_FreeLocation = m_Locations[id].node;
+    return id;
+  }
+
+  /**
+   * @brief Libère l'emplacement d'un identifiant, qui devient périmé.
+   *
+   * @param id L'identifiant, npos pour un élément sans identifiant (rien n'est fait).
+   */
+  void release(uint32_t id)
+  {
+    if (id == npos)
+      return;
+    SLocation& location = m_Locations[id];
+    ++location.generation;
+    location.slot = npos;
+    location.node = m_FreeLocation;
+    m_FreeLocation = id;
+  }
+
+  /**
+   * @brief Retourne l'emplacement de l'élément désigné par un identifiant, nullptr si l'identifiant est invalide.
+   */
+  const SLocation* locate(handle h) const
+  {
+    if (h.id >= m_Locations.size())
+      return nullptr;
+    const SLocation& location = m_Locations[h.id];
+    return location.slot != npos && location.generation == h.generation ? &location : nullptr;
+  }
+
+  /**
+   * @brief Retrouve un élément égal à t.
+   *
+   * Le noeud le plus profond existant sur le chemin de l'élément est parcouru d'abord, puis ses ancêtres.
+   *
+   * @param t L'élément à retrouver.
+   * @param [out] node Le noeud de l'élément trouvé.
+   * @param [out] slot L'index de l'élément trouvé dans la liste des données du noeud.
+   * @return false si l'élément n'est pas présent, true sinon.
+   */
+  bool search(const T& t, uint32_t& node, size_t& slot) const
+  {
+    for (node = find(boundsOf(t)); node != npos; node = m_Nodes[node].parent)
+    {
+      const bucket& elements = m_Nodes[node].elements;
+      auto found = std::find(elements.begin(), elements.end(), t);
+      if (found != elements.end())
+      {
+        slot = found - elements.begin();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Retourne le niveau d'un noeud, la racine étant au niveau 1.
+   */
+  size_t levelOf(uint32_t node) const
+  {
+    size_t level = 1;
+    for (; node != 0; node = m_Nodes[node].parent)
+      ++level;
+    return level;
+  }
+
+  /**
+   * @brief Vérifie si un noeud est sur le chemin d'insertion d'une zone incluse dans les limites du QuadTree.
+   *
+   * Le chemin d'insertion suit le point qui choisit les quadrants (coin supérieur gauche, ou centre pour un QuadTree lâche)
+   * tant que la zone tient dans les limites agrandies des cellules. Ces limites étant emboîtées, il suffit de vérifier
+   * que le point est dans la cellule du noeud (bord inférieur droit exclu, comme pour le choix des quadrants)
+   * et que la zone tient dans ses limites agrandies.
+   */
+  bool holds(uint32_t node, const limits_type& bounds) const
+  {
+    if (node == 0)
+      return true;
+    const limits_type& cell = m_Nodes[node].limits;
+    const limits_type& limits = m_Nodes[0].limits;
+    coordinate x = bounds.x1, y = bounds.y1;
+    if constexpr (Policy::looseness != 1.0f)
+    {
+      x = (bounds.x1 + bounds.x2) / 2.0f;
+      y = (bounds.y1 + bounds.y2) / 2.0f;
+    }
+    return x >= cell.x1 && (x < cell.x2 || cell.x2 == limits.x2) && y >= cell.y1 && (y < cell.y2 || cell.y2 == limits.y2)
+      && isInscribed(bounds, looseLimits(cell));
+  }
+
+  /**
+   * @brief Range un nouvel élément à partir de la racine, si elle peut le contenir (voir admit).
+   *
+   * @param t L'élément, copié ou déplacé selon U.
+   * @param pId Reçoit l'identifiant attribué à l'élément, nullptr pour un élément sans identifiant.
+   * @return false si l'élément est en dehors des limites du QuadTree (il n'est alors ni rangé, ni déplacé), true sinon.
+   */
+  template <typename U>
+  bool add(U&& t, uint32_t* pId)
+  {
+    const limits_type bounds = boundsOf(t);
+    restoreRoot();
+    if (!admit(bounds))
+      return false;
+
+    uint32_t id = npos;
+    if (pId != nullptr)
+    {
+      id = *pId = acquire();
+      m_Locations[id].placement = bounds;
+    }
+    store(0, 1, bounds, std::forward<U>(t), id);
+    return true;
+  }
+
+  /**
+   * @brief Remplace l'élément désigné par un identifiant (voir update).
+   */
+  template <typename U>
+  bool replace(handle h, U&& t)
+  {
+    const SLocation* pLocation = locate(h);
+    if (pLocation == nullptr)
+      return false;
+    const limits_type bounds = boundsOf(t);
+    if (!admit(bounds))
+      throw std::domain_error("TQuadTree::update : l'élément est en dehors des limites du QuadTree");
+
+    const uint32_t node = pLocation->node;
+    const uint32_t slot = pLocation->slot;
+    size_t level;
+    SNode& current = m_Nodes[node];
+    //Le noeud reste celui de l'élément s'il est le plus profond sur son chemin et qu'une insertion ne le subdiviserait pas
+    if (find(bounds, level) == node && (current.firstChild != npos || level >= Policy::maxDepth
+      || current.elements.size() <= Policy::bucketCapacity || quadrantOf(current.limits, bounds) == npos))
+    {
+      current.elements[slot] = std::forward<U>(t);
+      setBounds(current, slot, bounds);
+      m_Locations[h.id].placement = bounds;
+      return true;
+    }
+    erase(node, slot);
+    m_Locations[h.id].placement = bounds;
+    store(0, 1, bounds, std::forward<U>(t), h.id);
+    collapse(node);
+    return true;
+  }
+
+  /**
+   * @brief Déplace l'élément désigné par un identifiant (voir relocate).
+   */
+  template <typename U>
+  bool reposition(handle h, U&& t, coordinate margin)
+  {
+    const SLocation* pLocation = locate(h);
+    if (pLocation == nullptr)
+      return false;
+    const limits_type bounds = boundsOf(t);
+    if (!admit(bounds))
+      throw std::domain_error("TQuadTree::relocate : l'élément est en dehors des limites du QuadTree");
+    const limits_type& limits = m_Nodes[0].limits;
+
+    if (margin > 0.0f && isInscribed(bounds, pLocation->placement))
+    {
+      SNode& current = m_Nodes[pLocation->node];
+      current.elements[pLocation->slot] = std::forward<U>(t);
+      setBounds(current, pLocation->slot, bounds);
+      return true;
+    }
+    const limits_type placement = { std::max(bounds.x1 - margin, limits.x1), std::max(bounds.y1 - margin, limits.y1),
+                                std::min(bounds.x2 + margin, limits.x2), std::min(bounds.y2 + margin, limits.y2) };
+    m_Locations[h.id].placement = placement;
+    move(pLocation->node, pLocation->slot, placement, std::forward<U>(t), h.id);
+    return true;
+  }
+
+  /**
+   * @brief Déplace un élément en remontant de son noeud jusqu'au premier ancêtre qui contient sa nouvelle zone.
+   *
+   * @param node Le noeud de l'élément.
+   * @param slot L'index de l'élément dans la liste des données du noeud.
+   * @param bounds La zone servant à ranger le nouvel élément, incluse dans les limites du QuadTree.
+   * @param t Le nouvel élément.
+   * @param id L'identifiant de l'élément, npos s'il n'en a pas.
+   */
+  template <typename U>
+  void move(uint32_t node, size_t slot, const limits_type& bounds, U&& t, uint32_t id)
+  {
+    uint32_t ancestor = node;
+    size_t level = levelOf(node);
+    for (; !holds(ancestor, bounds); --level)
+      ancestor = m_Nodes[ancestor].parent;
+
+    //L'élément reste sur place si une insertion depuis son noeud s'y arrêterait
+    SNode& current = m_Nodes[node];
+    if (ancestor == node && (level >= Policy::maxDepth || quadrantOf(current.limits, bounds) == npos
+      || (current.firstChild == npos && current.elements.size() <= Policy::bucketCapacity)))
+    {
+      setBounds(current, slot, boundsOf(t));
+      current.elements[slot] = std::forward<U>(t);
+      return;
+    }
+    erase(node, slot);
+    store(ancestor, level, bounds, std::forward<U>(t), id);
+    for (ancestor = m_Nodes[ancestor].parent; ancestor != npos; ancestor = m_Nodes[ancestor].parent)
+      ++m_Nodes[ancestor].subtreeSize;
+    collapse(node);
+  }
+
+  /**
+   * @brief Range un élément dans le noeud le plus profond qui le contient, à partir d'un noeud donné.
+   *
+   * Une feuille pleine (au sens de Policy::bucketCapacity) est subdivisée lorsque l'élément tient dans l'un de ses enfants,
+   * sauf si elle a atteint Policy::maxDepth.
+   * L'élément est compté dans les noeuds traversés, du noeud de départ à son noeud : les ancêtres du noeud de départ
+   * sont à la charge de l'appelant.
+   *
+   * @param node Le noeud de départ, qui contient l'élément.
+   * @param level Le niveau de ce noeud.
+   * @param bounds La zone servant à ranger l'élément : ses limites, ou une zone qui les contient (voir relocate).
+   * @param t L'élément à ranger.
+   * @param id L'identifiant de l'élément, npos s'il n'en a pas.
+   */
+  template <typename U>
+  void store(uint32_t node, size_t level, const limits_type& bounds, U&& t, uint32_t id)
+  {
+    //Les limites des cellules sont recalculées en descendant plutôt que relues dans les noeuds
+    limits_type cell = m_Nodes[node].limits, child;
+    for (uint32_t quadrant; level < Policy::maxDepth && (quadrant = quadrantOf(cell, bounds, child)) != npos; ++level)
+    {
+      if (m_Nodes[node].firstChild == npos)
+      {
+        if (m_Nodes[node].elements.size() < Policy::bucketCapacity)
+          break;
+        split(node, level);
+      }
+      ++m_Nodes[node].subtreeSize;
+      node = m_Nodes[node].firstChild + quadrant;
+      cell = child;
+    }
+    ++m_Nodes[node].subtreeSize;
+    append(node, std::forward<U>(t), id);
+    if (level > m_Depth)
+      m_Depth = level;
+  }
+
+  /**
+   * @brief Vérifie qu'une zone peut être rangée dans le QuadTree, en agrandissant la racine si la politique le permet.
+   *
+   * @return false si la zone est en dehors des limites du QuadTree et qu'elle ne peut pas y être ramenée, true sinon.
+   */
+  bool admit(const limits_type& bounds)
+  {
+    if (isInscribed(bounds, m_Nodes[0].limits))
+      return true;
+    if constexpr (Policy::growable)
+    {
+      if (!isFinite(bounds) || bounds.x1 > bounds.x2 || bounds.y1 > bounds.y2)
+        return false;
+      while (!isInscribed(bounds, m_Nodes[0].limits))
+        grow(bounds);
+      return true;
+    }
+    else
+      return false;
+  }
+
+  /**
+   * @brief Double la racine vers une zone qui en déborde.
+   *
+   * La racine grandit vers l'ouest si la zone déborde à l'ouest, vers l'est sinon, et de même vers le nord ou le sud.
+   * L'ancienne racine devient l'enfant correspondant de la nouvelle avec toute sa descendance et ses éléments :
+   * seuls les liens vers l'ancienne racine (parent de ses enfants, emplacements de ses éléments) sont mis à jour.
+   */
+  void grow(const limits_type& bounds)
+  {
+    const limits_type old = m_Nodes[0].limits;
+    const coordinate width = old.x2 - old.x1;
+    const coordinate height = old.y2 - old.y1;
+    const uint32_t east = bounds.x1 < old.x1;
+    const uint32_t south = bounds.y1 < old.y1;
+    const limits_type limits = { east ? old.x1 - width : old.x1, south ? old.y1 - height : old.y1,
+                             east ? old.x2 : old.x2 + width, south ? old.y2 : old.y2 + height };
+    //Une racine vide n'a pas de descendance à conserver
+    if (m_Nodes[0].firstChild == npos && m_Nodes[0].elements.empty())
+    {
+      m_Nodes[0].limits = limits;
+      return;
+    }
+
+    SNode root = std::move(m_Nodes[0]);
+    m_Nodes[0] = makeNode(limits, npos);
+    createChildren(0);
+    const uint32_t moved = m_Nodes[0].firstChild + (east | south << 1);
+    root.parent = 0;
+    m_Nodes[moved] = std::move(root);
+    if (const uint32_t firstChild = m_Nodes[moved].firstChild; firstChild != npos)
+      for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+        m_Nodes[firstChild + quadrant].parent = moved;
+    for (uint32_t id : m_Nodes[moved].handles)
+      if (id != npos)
+        m_Locations[id].node = moved;
+    m_Nodes[0].subtreeSize = m_Nodes[moved].subtreeSize;
+    if (!m_DepthStale && m_Nodes[0].subtreeSize != 0)
+      ++m_Depth;
+    else
+      m_DepthStale = true;
+  }
+
+  /**
+   * @brief Crée les quatre enfants d'un noeud, à la suite dans le tableau des noeuds.
+   *
+   * Un groupe de noeuds libéré par collapse est réutilisé s'il y en a un, sinon les enfants sont ajoutés à la fin du tableau.
+   */
+  void createChildren(uint32_t node)
+  {
+    const limits_type cell = m_Nodes[node].limits;
+    uint32_t firstChild;
+    if (m_FreeChildren.empty())
+    {
+      firstChild = static_cast<uint32_t>(m_Nodes.size());
+      for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+        m_Nodes.push_back(makeNode(quadrantLimits(cell, quadrant), node));
+    }
+    else
+    {
+      firstChild = m_FreeChildren.back();
+      m_FreeChildren.pop_back();
+      for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+      {
+        m_Nodes[firstChild + quadrant].limits = quadrantLimits(cell, quadrant);
+        m_Nodes[firstChild + quadrant].parent = node;
+      }
+    }
+    m_Nodes[node].firstChild = firstChild;
+  }
+
+  /**
+   * @brief Supprime les quatre enfants d'un noeud, qui doivent être des feuilles vides.
+   *
+   * Les enfants en fin de tableau sont retirés, les autres sont vidés de leur mémoire et gardés pour createChildren.
+   */
+  void removeChildren(uint32_t node)
+  {
+    const uint32_t firstChild = std::exchange(m_Nodes[node].firstChild, npos);
+    if (firstChild + 4 == m_Nodes.size())
+      m_Nodes.erase(m_Nodes.begin() + firstChild, m_Nodes.end());
+    else
+    {
+      for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+        m_Nodes[firstChild + quadrant] = makeNode(m_Nodes[firstChild + quadrant].limits, node);
+      m_FreeChildren.push_back(firstChild);
+    }
+  }
+
+  /**
+   * @brief Fusionne les enfants d'un noeud dont un élément a été retiré, puis ceux de ses ancêtres, tant qu'ils sont peu remplis.
+   *
+   * Les enfants d'un noeud sont fusionnés lorsqu'ils sont tous des feuilles et qu'ils sont vides, ou qu'avec le noeud
+   * ils ne contiennent pas plus de mergeCapacity éléments : leurs éléments remontent alors dans le noeud.
+   * Ce seuil étant la moitié de Policy::bucketCapacity, une feuille qui vient d'être subdivisée ne l'est pas à nouveau
+   * au moindre retrait suivi d'une insertion (hystérésis).
+   * Sans capacité de feuilles, seuls les enfants vides sont supprimés : les éléments restent dans leur cellule la plus profonde.
+   *
+   * @param node Le noeud dont un élément a été retiré.
+   */
+  void collapse(uint32_t node)
+  {
+    for (; node != npos; node = m_Nodes[node].parent)
+    {
+      const uint32_t firstChild = m_Nodes[node].firstChild;
+      if (firstChild == npos)
+        continue;
+      size_t count = 0;
+      for (uint32_t child = firstChild; child < firstChild + 4; ++child)
+      {
+        if (m_Nodes[child].firstChild != npos)
+          return;
+        count += m_Nodes[child].elements.size();
+      }
+      if (count != 0 && count + m_Nodes[node].elements.size() > mergeCapacity)
+        return;
+
+      for (uint32_t child = firstChild; child < firstChild + 4; ++child)
+      {
+        SNode& current = m_Nodes[child];
+        for (size_t slot = 0; slot < current.elements.size(); ++slot)
+          append(node, std::move(current.elements[slot]), current.handles[slot]);
+      }
+      removeChildren(node);
+    }
+  }
+
+  /**
+   * @brief Subdivise un noeud.
+   *
+   * Si les feuilles ont une capacité, les éléments du noeud qui tiennent dans un enfant y sont déplacés.
+   *
+   * @param node Le noeud à subdiviser.
+   * @param level Le niveau de ce noeud.
+   */
+  void split(uint32_t node, size_t level)
+  {
+    createChildren(node);
+
+    if constexpr (Policy::bucketCapacity > 0)
+    {
+      bucket elements(std::move(m_Nodes[node].elements));
+      index_list handles(std::move(m_Nodes[node].handles));
+      m_Nodes[node].elements.clear();
+      m_Nodes[node].bounds.clear();
+      m_Nodes[node].handles.clear();
+      //Les éléments restent dans le sous-arbre du noeud : ils n'y sont décomptés que le temps d'être rangés à nouveau
+      m_Nodes[node].subtreeSize -= elements.size();
+      for (size_t index = 0; index < elements.size(); ++index)
+      {
+        //Un élément déplacé avec une marge est rangé selon sa zone agrandie
+        const limits_type bounds = handles[index] != npos ? m_Locations[handles[index]].placement : boundsOf(elements[index]);
+        store(node, level, bounds, std::move(elements[index]), handles[index]);
+      }
+    }
+  }
+
+  /**
+   * @brief Remplace le contenu du QuadTree par les éléments d'une liste indexable (voir assign).
+   */
+  template <typename Elements>
+  void bulkLoad(const Elements& elements)
+  {
+    restoreRoot();
+    const size_t count = std::ranges::size(elements);
+    auto items = std::ranges::begin(elements);
+    //La racine d'un QuadTree extensible est agrandie une fois pour toutes jusqu'à l'union des éléments
+    limits_type extent = m_Nodes[0].limits;
+    for (size_t index = 0; index < count; ++index)
+    {
+      const limits_type bounds = boundsOf(items[index]);
+      if (Policy::growable && isFinite(bounds))
+        extent = { std::min(extent.x1, bounds.x1), std::min(extent.y1, bounds.y1),
+                   std::max(extent.x2, bounds.x2), std::max(extent.y2, bounds.y2) };
+      else if (!isInscribed(bounds, m_Nodes[0].limits))
+        throw std::domain_error("TQuadTree::assign : un élément est en dehors des limites du QuadTree");
+    }
+    clear();
+    admit(extent);
+
+    //Chemin de chaque élément jusqu'à sa cellule la plus profonde, en créant les noeuds au passage
+    std::vector<uint32_t> destinations;
+    destinations.reserve(count);
+    std::vector<size_t> sizes(1);
+    for (size_t index = 0; index < count; ++index)
+    {
+      const limits_type bounds = boundsOf(items[index]);
+      uint32_t node = 0;
+      size_t level = 1;
+      limits_type cell = m_Nodes[0].limits, child;
+      for (uint32_t quadrant; level < Policy::maxDepth && (quadrant = quadrantOf(cell, bounds, child)) != npos; ++level)
+      {
+        if (m_Nodes[node].firstChild == npos)
+        {
+          createChildren(node);
+          sizes.resize(m_Nodes.size());
+        }
+        node = m_Nodes[node].firstChild + quadrant;
+        cell = child;
+      }
+      destinations.push_back(node);
+      ++sizes[node];
+    }
+
+    //Avec une capacité de feuilles, un sous-arbre qui ne déborde pas est réduit à sa racine.
+    //Les enfants sont toujours après leur parent : les totaux se cumulent en remontant les index, les feuilles se propagent en les descendant.
+    std::vector<uint32_t> owners(m_Nodes.size());
+    std::vector<bool> leaves(m_Nodes.size());
+    for (uint32_t node = 0; node < m_Nodes.size(); ++node)
+      owners[node] = node;
+    if constexpr (Policy::bucketCapacity > 0)
+    {
+      std::vector<size_t> totals = sizes;
+      for (uint32_t node = static_cast<uint32_t>(m_Nodes.size()) - 1; node > 0; --node)
+        totals[m_Nodes[node].parent] += totals[node];
+      for (uint32_t node = 0; node < m_Nodes.size(); ++node)
+      {
+        const uint32_t parent = m_Nodes[node].parent;
+        if (node != 0 && owners[parent] != parent)
+          owners[node] = owners[parent];
+        else if (node != 0 && leaves[parent])
+          owners[node] = parent;
+        else
+          leaves[node] = totals[node] <= Policy::bucketCapacity;
+      }
+      for (uint32_t node = 0; node < m_Nodes.size(); ++node)
+        if (owners[node] != node)
+          sizes[owners[node]] += std::exchange(sizes[node], 0);
+    }
+
+    //Renumérotation des noeuds conservés en profondeur d'abord (ordre de Morton des cellules), listes de données réservées à leur taille finale
+    node_array nodes(m_Nodes.get_allocator());
+    nodes.reserve(m_Nodes.size());
+    std::vector<uint32_t> renumbered(m_Nodes.size(), npos);
+    nodes.push_back(makeNode(m_Nodes[0].limits, npos));
+    relayout(0, 0, 1, nodes, renumbered, sizes, leaves);
+    for (uint32_t node = 0; node < m_Nodes.size(); ++node)
+      renumbered[node] = renumbered[owners[node]];
+    m_Nodes = std::move(nodes);
+
+    for (size_t index = 0; index < count; ++index)
+      append(renumbered[destinations[index]], items[index], npos);
+    //Les enfants sont toujours après leur parent : les totaux des sous-arbres se cumulent en remontant les index
+    for (SNode& node : m_Nodes)
+      node.subtreeSize = node.elements.size();
+    for (uint32_t node = static_cast<uint32_t>(m_Nodes.size()) - 1; node > 0; --node)
+      m_Nodes[m_Nodes[node].parent].subtreeSize += m_Nodes[node].subtreeSize;
+  }
+
+  /**
+   * @brief Recopie en profondeur d'abord le sous-arbre d'un noeud dans un nouveau tableau de noeuds.
+   *
+   * @param node Le noeud dans m_Nodes.
+   * @param target Le noeud correspondant, déjà créé dans nodes.
+   * @param level Le niveau du noeud.
+   * @param nodes Le nouveau tableau de noeuds.
+   * @param [out] renumbered L'index dans nodes de chaque noeud de m_Nodes recopié.
+   * @param sizes Le nombre d'éléments de chaque noeud de m_Nodes.
+   * @param leaves Les noeuds de m_Nodes dont les enfants ne sont pas recopiés.
+   */
+  void relayout(uint32_t node, uint32_t target, size_t level, node_array& nodes, std::vector<uint32_t>& renumbered,
+    const std::vector<size_t>& sizes, const std::vector<bool>& leaves)
+  {
+    renumbered[node] = target;
+    if (sizes[node] != 0)
+    {
+      nodes[target].elements.reserve(sizes[node]);
+      nodes[target].bounds.reserve(sizes[node]);
+      nodes[target].handles.reserve(sizes[node]);
+      if (level > m_Depth)
+        m_Depth = level;
+    }
+
+    const uint32_t firstChild = m_Nodes[node].firstChild;
+    if (firstChild == npos || leaves[node])
+      return;
+    const uint32_t targetChild = static_cast<uint32_t>(nodes.size());
+    for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+      nodes.push_back(makeNode(m_Nodes[firstChild + quadrant].limits, target));
+    nodes[target].firstChild = targetChild;
+    for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+      relayout(firstChild + quadrant, targetChild + quadrant, level + 1, nodes, renumbered, sizes, leaves);
+  }
+
+  /**
+   * @brief Retrouve le noeud dans lequel un élément de limites bounds est stocké.
+   *
+   * C'est le noeud le plus profond existant sur le chemin d'insertion de l'élément.
+   *
+   * @param [out] level Le niveau du noeud.
+   * @return L'index du noeud, ou npos si l'élément est en dehors des limites du QuadTree.
+   */
+  uint32_t find(const limits_type& bounds, size_t& level) const
+  {
+    if (m_Nodes.empty() || !isInscribed(bounds, m_Nodes[0].limits))
+      return npos;
+
+    uint32_t node = 0;
+    level = 1;
+    for (uint32_t quadrant; level < Policy::maxDepth && m_Nodes[node].firstChild != npos
+      && (quadrant = quadrantOf(m_Nodes[node].limits, bounds)) != npos; ++level)
+      node = m_Nodes[node].firstChild + quadrant;
+    return node;
+  }
+
+  /**
+   * @brief Retrouve le noeud dans lequel un élément de limites bounds est stocké (voir l'autre surcharge).
+   */
+  uint32_t find(const limits_type& bounds) const
+  {
+    size_t level;
+    return find(bounds, level);
+  }
+
+  /**
+   * @brief Vérifie si les éléments d'un noeud de limites cell peuvent satisfaire une requête.
+   */
+  static bool accepts(const limits_type& cell, EQuery query, const limits_type& limits)
+  {
+    return query == EQuery::all || isColliding(looseLimits(cell), limits);
+  }
+
+  /**
+   * @brief Vérifie si tous les éléments d'un noeud de limites cell satisfont une requête, sans les tester.
+   *
+   * Les éléments d'un noeud tiennent dans sa cellule agrandie (voir looseLimits) : si elle est incluse dans la zone
+   * de la requête, ils sont tous à la fois inclus dans la zone et en collision avec elle, comme ceux de sa descendance.
+   */
+  static bool covers(const limits_type& cell, EQuery query, const limits_type& limits)
+  {
+    return query == EQuery::all || isInscribed(looseLimits(cell), limits);
+  }
+
+  /**
+   * @brief Retourne le premier noeud d'un parcours en profondeur.
+   */
+  uint32_t first(EQuery query, const limits_type& limits) const
+  {
+    return !m_Nodes.empty() && accepts(m_Nodes[0].limits, query, limits) ? 0 : npos;
+  }
+
+  /**
+   * @brief Retourne le noeud suivant d'un parcours en profondeur.
+   *
+   * Le parcours n'a besoin d'aucune pile : les frères d'un noeud sont contigus et chaque noeud connaît son parent.
+   * Les noeuds dont la cellule ne peut satisfaire la requête, ou dont le sous-arbre est vide, sont ignorés avec toute leur descendance.
+   *
+   * @param node Le noeud courant.
+   * @param descend true pour visiter les enfants du noeud courant, false pour les ignorer.
+   * @return L'index du noeud suivant, ou npos à la fin du parcours.
+   */
+  uint32_t next(uint32_t node, bool descend, EQuery query, const limits_type& limits) const
+  {
+    for (;;)
+    {
+      if (descend && m_Nodes[node].firstChild != npos)
+        node = m_Nodes[node].firstChild;
+      else
+      {
+        while (node != 0 && ((node - 1) & 3) == 3)
+          node = m_Nodes[node].parent;
+        if (node == 0)
+          return npos;
+        ++node;
+      }
+      if (m_Nodes[node].subtreeSize != 0 && accepts(m_Nodes[node].limits, query, limits))
+        return node;
+      descend = false;
+    }
+  }
+
+  /**
+   * @brief Appelle une fonction sur un élément, en traduisant un retour void en true.
+   *
+   * @return false si la fonction demande l'interruption du parcours, true sinon.
+   */
+  template <typename F>
+  static bool call(F& f, const T& t)
+  {
+    if constexpr (std::is_void_v<std::invoke_result_t<F&, const T&>>)
+    {
+      std::invoke(f, t);
+      return true;
+    }
+    else
+      return std::invoke(f, t);
+  }
+
+  /**
+   * @brief Appelle une fonction pour chaque élément satisfaisant une requête.
+   *
+   * @return false si la fonction a interrompu le parcours en retournant false, true sinon.
+   */
+  template <typename F>
+  bool visit(EQuery query, const limits_type& limits, F& f) const
+  {
+    auto each = [&f](const bucket& elements)
+    {
+      for (const T& t : elements)
+        if (!call(f, t))
+          return false;
+      return true;
+    };
+    return visit(query, limits, f, each);
+  }
+
+  /**
+   * @brief Appelle une fonction pour chaque élément satisfaisant une requête, et une autre pour les noeuds qui la satisfont en entier.
+   *
+   * Les éléments d'un noeud dont la cellule est incluse dans la zone de la requête (voir covers) ne sont pas testés :
+   * ils sont tous passés d'un coup à whole, qui peut par exemple les ajouter à une liste en une seule copie.
+   * Pour une requête qui englobe presque tout le monde (une vue dézoomée), c'est le cas de presque tous les noeuds.
+   *
+   * @param f La fonction appelée pour chaque élément testé (const T&).
+   * @param whole La fonction appelée avec tous les éléments d'un noeud (const bucket&), qui retourne false pour interrompre le parcours.
+   * @return false si une fonction a interrompu le parcours, true sinon.
+   */
+  template <typename F, typename G>
+  bool visit(EQuery query, const limits_type& limits, F& f, G& whole) const
+  {
+    for (uint32_t node = first(query, limits); node != npos; node = next(node, true, query, limits))
+    {
+      const SNode& current = m_Nodes[node];
+      if (covers(current.limits, query, limits))
+      {
+        if (!whole(current.elements))
+          return false;
+        continue;
+      }
+      //Les blocs d'un noeud sont testés par paquets, en un seul appel au test du jeu d'instructions choisi
+      unsigned masks[64];
+      for (size_t first = 0; first < current.bounds.blockCount(); first += std::size(masks))
+      {
+        const size_t count = std::min(std::size(masks), current.bounds.blockCount() - first);
+        matchMasks(current, first, count, query, limits, masks);
+        for (size_t block = 0; block < count; ++block)
+          for (unsigned mask = masks[block]; mask != 0; mask &= mask - 1)
+            if (!call(f, current.elements[(first + block) * bounds_array::width + std::countr_zero(mask)]))
+              return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Appelle une fonction pour chaque élément satisfaisant une requête sur une forme (voir QueryShape).
+   *
+   * Le parcours suit les noeuds en collision avec le rectangle englobant de la forme. Un noeud dont la cellule agrandie
+   * ne touche pas la forme est ignoré avec toute sa descendance ; un noeud dont la cellule agrandie est incluse dans la forme
+   * est passé d'un coup à whole (voir visit). Les éléments des autres noeuds sont d'abord filtrés sur le rectangle englobant
+   * par le test des blocs, puis seuls les éléments retenus sont testés exactement sur la forme.
+   *
+   * @param query EQuery::colliding ou EQuery::inscribed.
+   * @param shape La forme.
+   * @param f La fonction appelée pour chaque élément testé (const T&).
+   * @param whole La fonction appelée avec tous les éléments d'un noeud (const bucket&), qui retourne false pour interrompre le parcours.
+   * @return false si une fonction a interrompu le parcours, true sinon.
+   */
+  template <typename S, typename F, typename G>
+  bool visitShape(EQuery query, const S& shape, F& f, G& whole) const
+  {
+    const limits_type box = boundsOf(shape);
+    for (uint32_t node = first(EQuery::colliding, box); node != npos;)
+    {
+      const SNode& current = m_Nodes[node];
+      const limits_type loose = looseLimits(current.limits);
+      if (!shape.intersects(loose))
+      {
+        node = next(node, false, EQuery::colliding, box);
+        continue;
+      }
+      if (shape.contains(loose))
+      {
+        if (!whole(current.elements))
+          return false;
+        node = next(node, true, EQuery::colliding, box);
+        continue;
+      }
+      unsigned masks[64];
+      for (size_t first = 0; first < current.bounds.blockCount(); first += std::size(masks))
+      {
+        const size_t count = std::min(std::size(masks), current.bounds.blockCount() - first);
+        matchMasks(current, first, count, query, box, masks);
+        for (size_t block = 0; block < count; ++block)
+          for (unsigned mask = masks[block]; mask != 0; mask &= mask - 1)
+          {
+            const T& t = current.elements[(first + block) * bounds_array::width + std::countr_zero(mask)];
+            const limits_type bounds = boundsOf(t);
+            if ((query == EQuery::colliding ? shape.intersects(bounds) : shape.contains(bounds)) && !call(f, t))
+              return false;
+          }
+      }
+      node = next(node, true, EQuery::colliding, box);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Appelle une fonction pour chaque élément d'un sous-arbre qui contient un point.
+   *
+   * Seuls les enfants dont la cellule agrandie contient le point sont visités : un seul par niveau pour un QuadTree strict,
+   * sauf pour un point sur le bord commun de deux cellules. Avec un QuadTree lâche, les cellules agrandies se chevauchent
+   * et jusqu'à quatre enfants peuvent contenir le point.
+   *
+   * @param node La racine du sous-arbre.
+   * @param point Le point, sous forme de limites réduites à ce point.
+   * @return false si la fonction a interrompu le parcours en retournant false, true sinon.
+   */
+  template <typename F>
+  bool visitContaining(uint32_t node, const limits_type& point, F& f) const
+  {
+    if (m_Nodes.empty())
+      return true;
+    const SNode& current = m_Nodes[node];
+    if (current.subtreeSize == 0 || !isInscribed(point, looseLimits(current.limits)))
+      return true;
+    unsigned masks[64];
+    for (size_t first = 0; first < current.bounds.blockCount(); first += std::size(masks))
+    {
+      const size_t count = std::min(std::size(masks), current.bounds.blockCount() - first);
+      matchMasks(current, first, count, EQuery::colliding, point, masks);
+      for (size_t block = 0; block < count; ++block)
+        for (unsigned mask = masks[block]; mask != 0; mask &= mask - 1)
+          if (!call(f, current.elements[(first + block) * bounds_array::width + std::countr_zero(mask)]))
+            return false;
+    }
+    if (current.firstChild != npos)
+      for (uint32_t child = current.firstChild; child < current.firstChild + 4; ++child)
+        if (!visitContaining(child, point, f))
+          return false;
+    return true;
+  }
+
+  /**
+   * @brief Cherche les k éléments les plus proches d'un point (voir findNearest).
+   *
+   * Les noeuds à visiter sont dans une file de priorité, ordonnés par le minorant de la distance à leur cellule agrandie.
+   * Les k meilleurs candidats sont dans un tas dont le sommet est le plus éloigné, qui est remplacé par tout élément plus proche.
+   *
+   * @return Les candidats retenus (distance, élément), triés du plus proche au plus éloigné.
+   */
+  template <typename Metric>
+  std::vector<std::pair<coordinate, const T*>> findNearestCandidates(coordinate x, coordinate y, size_t k, const Metric& metric) const
+  {
+    using candidate = std::pair<coordinate, const T*>;
+    using entry = std::pair<coordinate, uint32_t>;
+    auto closer = [](const candidate& a, const candidate& b) { return a.first < b.first; };
+    std::vector<candidate> best;
+    if (k == 0 || empty())
+      return best;
+    best.reserve(std::min(k, size()));
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> nodes;
+    nodes.push({ metric.bound(looseLimits(m_Nodes[0].limits), x, y), 0 });
+    while (!nodes.empty())
+    {
+      const auto [bound, node] = nodes.top();
+      if (best.size() == k && bound > best.front().first)
+        break;
+      nodes.pop();
+
+      const SNode& current = m_Nodes[node];
+      for (const T& t : current.elements)
+      {
+        const coordinate distance = metric(boundsOf(t), x, y);
+        if (best.size() < k)
+        {
+          best.push_back({ distance, &t });
+          std::push_heap(best.begin(), best.end(), closer);
+        }
+        else if (distance < best.front().first)
+        {
+          std::pop_heap(best.begin(), best.end(), closer);
+          best.back() = { distance, &t };
+          std::push_heap(best.begin(), best.end(), closer);
+        }
+      }
+      if (current.firstChild == npos)
+        continue;
+      for (uint32_t child = current.firstChild; child < current.firstChild + 4; ++child)
+      {
+        if (m_Nodes[child].subtreeSize == 0)
+          continue;
+        const coordinate childBound = metric.bound(looseLimits(m_Nodes[child].limits), x, y);
+        if (best.size() < k || childBound <= best.front().first)
+          nodes.push({ childBound, child });
+      }
+    }
+    std::sort_heap(best.begin(), best.end(), closer);
+    return best;
+  }
+
+  /**
+   * @brief Compte les éléments satisfaisant une requête.
+   *
+   * Un sous-arbre dont la racine couvre la requête (voir covers) est compté d'un bloc.
+   */
+  size_t countMatches(EQuery query, const limits_type& limits) const
+  {
+    size_t count = 0;
+    for (uint32_t node = first(query, limits); node != npos;)
+    {
+      const SNode& current = m_Nodes[node];
+      if (covers(current.limits, query, limits))
+      {
+        count += current.subtreeSize;
+        node = next(node, false, query, limits);
+        continue;
+      }
+      unsigned masks[64];
+      for (size_t first = 0; first < current.bounds.blockCount(); first += std::size(masks))
+      {
+        const size_t blocks = std::min(std::size(masks), current.bounds.blockCount() - first);
+        matchMasks(current, first, blocks, query, limits, masks);
+        for (size_t block = 0; block < blocks; ++block)
+          count += std::popcount(masks[block]);
+      }
+      node = next(node, true, query, limits);
+    }
+    return count;
+  }
+
+  /**
+   * @brief Compte les éléments satisfaisant une requête sur une forme (voir visitShape).
+   *
+   * Un sous-arbre dont la racine est incluse dans la forme est compté d'un bloc.
+   */
+  template <typename S>
+  size_t countShape(EQuery query, const S& shape) const
+  {
+    const limits_type box = boundsOf(shape);
+    size_t count = 0;
+    for (uint32_t node = first(EQuery::colliding, box); node != npos;)
+    {
+      const SNode& current = m_Nodes[node];
+      const limits_type loose = looseLimits(current.limits);
+      if (!shape.intersects(loose))
+      {
+        node = next(node, false, EQuery::colliding, box);
+        continue;
+      }
+      if (shape.contains(loose))
+      {
+        count += current.subtreeSize;
+        node = next(node, false, EQuery::colliding, box);
+        continue;
+      }
+      unsigned masks[64];
+      for (size_t first = 0; first < current.bounds.blockCount(); first += std::size(masks))
+      {
+        const size_t blocks = std::min(std::size(masks), current.bounds.blockCount() - first);
+        matchMasks(current, first, blocks, query, box, masks);
+        for (size_t block = 0; block < blocks; ++block)
+          for (unsigned mask = masks[block]; mask != 0; mask &= mask - 1)
+          {
+            const limits_type bounds = boundsOf(current.elements[(first + block) * bounds_array::width + std::countr_zero(mask)]);
+            count += query == EQuery::colliding ? shape.intersects(bounds) : shape.contains(bounds);
+          }
+      }
+      node = next(node, true, EQuery::colliding, box);
+    }
+    return count;
+  }
+
+  /**
+   * @brief Ajoute à result tous les éléments satisfaisant une requête.
+   *
+   * La liste est d'abord réservée à sa taille finale (voir countMatches) : pour une grande zone, ce comptage ne lit
+   * presque aucun élément et évite les réallocations successives de la liste, qui coûteraient plus que la requête.
+   * Les éléments d'un noeud qui satisfait la requête en entier sont ensuite ajoutés en une seule insertion,
+   * soit une seule copie mémoire pour un type trivialement copiable.
+   */
+  void collect(EQuery query, const limits_type& limits, container& result) const
+  {
+    auto add = [&result](const T& t) { result.push_back(t); };
+    auto addAll = [&result](const bucket& elements) { result.insert(result.end(), elements.begin(), elements.end()); return true; };
+    result.reserve(result.size() + countMatches(query, limits));
+    visit(query, limits, add, addAll);
+  }
+
+  /**
+   * @brief Ajoute à result l'adresse de tous les éléments satisfaisant une requête.
+   */
+  void collect(EQuery query, const limits_type& limits, std::vector<const T*>& result) const
+  {
+    auto add = [&result](const T& t) { result.push_back(&t); };
+    auto addAll = [&result](const bucket& elements)
+    {
+      for (const T& t : elements)
+        result.push_back(&t);
+      return true;
+    };
+    visit(query, limits, add, addAll);
+  }
+
+  /**
+   * @brief Ajoute à result tous les éléments satisfaisant une requête sur une forme (voir visitShape).
+   *
+   * Contrairement à collect, la liste n'est pas réservée d'avance : le comptage testerait deux fois chaque élément sur la forme.
+   */
+  template <typename S>
+  void collectShape(EQuery query, const S& shape, container& result) const
+  {
+    auto add = [&result](const T& t) { result.push_back(t); };
+    auto addAll = [&result](const bucket& elements) { result.insert(result.end(), elements.begin(), elements.end()); return true; };
+    visitShape(query, shape, add, addAll);
+  }
+
+  /**
+   * @brief Ajoute à result l'adresse de tous les éléments satisfaisant une requête sur une forme.
+   */
+  template <typename S>
+  void collectShape(EQuery query, const S& shape, std::vector<const T*>& result) const
+  {
+    auto add = [&result](const T& t) { result.push_back(&t); };
+    auto addAll = [&result](const bucket& elements)
+    {
+      for (const T& t : elements)
+        result.push_back(&t);
+      return true;
+    };
+    visitShape(query, shape, add, addAll);
+  }
+};
+
+/**
+ * @brief QuadTree dont toute la mémoire provient d'une std::pmr::memory_resource.
+ *
+ * @tparam T Le type des données à stocker.
+ * @tparam Policy La politique de subdivision (voir SQuadTreePolicy).
+ */
+template <QuadTreeData T, typename Policy = SQuadTreePolicy>
+using TPmrQuadTree = TQuadTree<T, Policy, std::pmr::polymorphic_allocator<T>>;
 
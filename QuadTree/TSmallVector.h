@@ -0,0 +1,263 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Liste contiguë dont les Capacity premiers éléments sont stockés dans l'objet lui-même.
+ *
+ * Tant qu'elle ne dépasse pas Capacity éléments, la liste n'alloue rien et ses éléments sont à côté de l'objet qui la contient :
+ * lire la liste d'un noeud de TQuadTree peu rempli ne demande alors ni allocation, ni accès à une autre ligne de cache.
+ * Au-delà, tous ses éléments sont déplacés dans un tableau alloué, comme pour un std::vector.
+ *
+ * Seules les opérations de std::vector utilisées par TQuadTree sont proposées.
+ *
+ * @tparam T Le type des éléments.
+ * @tparam Capacity Le nombre d'éléments stockés dans l'objet.
+ * @tparam Allocator L'allocateur utilisé au-delà de Capacity éléments.
+ */
+template <typename T, size_t Capacity, typename Allocator = std::allocator<T>>
+class TSmallVector
+{
+  static_assert(Capacity > 0, "Une liste sans éléments dans l'objet est un std::vector");
+  using traits = std::allocator_traits<Allocator>;
+
+public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using size_type = size_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+private:
+  [[no_unique_address]] Allocator m_Allocator; ///< L'allocateur utilisé au-delà de Capacity éléments
+  T* m_pData;                                  ///< Les éléments : m_Inline, ou un tableau alloué
+  size_t m_Size = 0;                           ///< Le nombre d'éléments
+  size_t m_Capacity = Capacity;                ///< Le nombre d'éléments que m_pData peut contenir
+  alignas(T) unsigned char m_Inline[Capacity * sizeof(T)]; ///< La place des éléments stockés dans l'objet
+
+  /**
+   * @brief Retourne la place des éléments stockés dans l'objet.
+   */
+  T* inlineData()
+  {
+    return reinterpret_cast<T*>(m_Inline);
+  }
+
+  /**
+   * @brief Vérifie si les éléments sont stockés dans l'objet.
+   */
+  bool isInline() const
+  {
+    return m_pData == reinterpret_cast<const T*>(m_Inline);
+  }
+
+  /**
+   * @brief Libère le tableau alloué, s'il y en a un, et revient à la place dans l'objet. La liste doit être vide.
+   */
+  void release()
+  {
+    if (!isInline())
+      traits::deallocate(m_Allocator, m_pData, m_Capacity);
+    m_pData = inlineData();
+    m_Capacity = Capacity;
+  }
+
+  /**
+   * @brief Déplace les éléments dans un tableau alloué de capacity éléments.
+   *
+   * @tparam Append true pour construire aussi un nouvel élément à la fin du tableau à partir de args.
+   * Il est construit avant le déplacement des autres éléments, qui peuvent être ses arguments.
+   * @param capacity La nouvelle capacité, supérieure au nombre d'éléments.
+   */
+  template <bool Append, typename... Args>
+  void reallocate(size_t capacity, Args&&... args)
+  {
+    T* pData = traits::allocate(m_Allocator, capacity);
+    size_t moved = 0;
+    bool appended = false;
+    try
+    {
+      if constexpr (Append)
+      {
+        traits::construct(m_Allocator, pData + m_Size, std::forward<Args>(args)...);
+        appended = true;
+      }
+      for (; moved < m_Size; ++moved)
+        traits::construct(m_Allocator, pData + moved, std::move_if_noexcept(m_pData[moved]));
+    }
+    catch (...)
+    {
+      for (size_t index = 0; index < moved; ++index)
+        traits::destroy(m_Allocator, pData + index);
+      if (appended)
+        traits::destroy(m_Allocator, pData + m_Size);
+      traits::deallocate(m_Allocator, pData, capacity);
+      throw;
+    }
+    const size_t size = m_Size + (Append ? 1 : 0);
+    clear();
+    release();
+    m_pData = pData;
+    m_Size = size;
+    m_Capacity = capacity;
+  }
+
+  /**
+   * @brief Prend les éléments d'une autre liste : son tableau s'il est compatible avec l'allocateur, sinon élément par élément.
+   */
+  void take(TSmallVector& other)
+  {
+    if (!other.isInline() && m_Allocator == other.m_Allocator)
+    {
+      m_pData = std::exchange(other.m_pData, other.inlineData());
+      m_Size = std::exchange(other.m_Size, 0);
+      m_Capacity = std::exchange(other.m_Capacity, Capacity);
+      return;
+    }
+    reserve(other.m_Size);
+    for (T& t : other)
+      traits::construct(m_Allocator, m_pData + m_Size++, std::move(t));
+    other.clear();
+  }
+
+public:
+  /**
+   * @brief Constructeur de la classe TSmallVector.
+   *
+   * @param allocator L'allocateur à utiliser au-delà de Capacity éléments.
+   */
+  explicit TSmallVector(const Allocator& allocator = Allocator())
+    : m_Allocator(allocator), m_pData(inlineData())
+  {
+  }
+
+  /**
+   * @brief Constructeur de copie.
+   */
+  TSmallVector(const TSmallVector& other)
+    : TSmallVector(traits::select_on_container_copy_construction(other.m_Allocator))
+  {
+    reserve(other.m_Size);
+    for (const T& t : other)
+      traits::construct(m_Allocator, m_pData + m_Size++, t);
+  }
+
+  /**
+   * @brief Constructeur de déplacement : un tableau alloué est repris tel quel, les éléments stockés dans l'objet sont déplacés.
+   */
+  TSmallVector(TSmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    : TSmallVector(other.m_Allocator)
+  {
+    take(other);
+  }
+
+  /**
+   * @brief Opérateur d'affectation par copie.
+   */
+  TSmallVector& operator=(const TSmallVector& other)
+  {
+    if (this != &other)
+    {
+      clear();
+      reserve(other.m_Size);
+      for (const T& t : other)
+        traits::construct(m_Allocator, m_pData + m_Size++, t);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Opérateur d'affectation par déplacement.
+   */
+  TSmallVector& operator=(TSmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>
+    && (traits::propagate_on_container_move_assignment::value || traits::is_always_equal::value))
+  {
+    if (this != &other)
+    {
+      clear();
+      release();
+      if constexpr (traits::propagate_on_container_move_assignment::value)
+        m_Allocator = other.m_Allocator;
+      take(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Destructeur de la classe TSmallVector.
+   */
+  ~TSmallVector()
+  {
+    clear();
+    release();
+  }
+
+  allocator_type get_allocator() const { return m_Allocator; }
+
+  size_t size() const { return m_Size; }
+  bool empty() const { return m_Size == 0; }
+  size_t capacity() const { return m_Capacity; }
+
+  T* data() { return m_pData; }
+  const T* data() const { return m_pData; }
+  T* begin() { return m_pData; }
+  const T* begin() const { return m_pData; }
+  T* end() { return m_pData + m_Size; }
+  const T* end() const { return m_pData + m_Size; }
+
+  T& operator[](size_t index) { return m_pData[index]; }
+  const T& operator[](size_t index) const { return m_pData[index]; }
+  T& back() { return m_pData[m_Size - 1]; }
+  const T& back() const { return m_pData[m_Size - 1]; }
+
+  /**
+   * @brief Réserve la place pour count éléments.
+   */
+  void reserve(size_t count)
+  {
+    if (count > m_Capacity)
+      reallocate<false>(count);
+  }
+
+  /**
+   * @brief Construit un élément à la fin de la liste.
+   *
+   * Les arguments peuvent désigner un élément de la liste elle-même.
+   */
+  template <typename... Args>
+  T& emplace_back(Args&&... args)
+  {
+    if (m_Size == m_Capacity)
+      reallocate<true>(m_Capacity * 2, std::forward<Args>(args)...);
+    else
+      traits::construct(m_Allocator, m_pData + m_Size++, std::forward<Args>(args)...);
+    return back();
+  }
+
+  void push_back(const T& t) { emplace_back(t); }
+  void push_back(T&& t) { emplace_back(std::move(t)); }
+
+  /**
+   * @brief Retire le dernier élément.
+   */
+  void pop_back()
+  {
+    traits::destroy(m_Allocator, m_pData + --m_Size);
+  }
+
+  /**
+   * @brief Retire tous les éléments, sans libérer le tableau alloué.
+   */
+  void clear()
+  {
+    for (size_t index = 0; index < m_Size; ++index)
+      traits::destroy(m_Allocator, m_pData + index);
+    m_Size = 0;
+  }
+};
@@ -0,0 +1,505 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <numbers>
+#include <random>
+#include <sstream>
+
+#include "test_fixtures.h"
+#include "TFrozenQuadTree.h"
+#include "CDataSet.h"
+
+//Benchmarks cachés, à exécuter explicitement par la ligne de commande, par exemple : tests "[.benchmark][frozen]" -s
+
+/**
+ * @brief Lit tous les rectangles du jeu de données des tests de performance (voir readDataSet).
+ */
+static std::vector<Rectangle> readRectangles(size_t& depth, size_t& datasetSize)
+{
+  std::vector<Rectangle> rects;
+  readDataSet(depth, datasetSize, [&rects](float x1, float y1, float x2, float y2) {
+    rects.emplace_back(x1, y1, x2, y2);
+    });
+  return rects;
+}
+
+/**
+ * @brief Benchmarke les politiques de subdivision sur le jeu de données des tests de performance.
+ *
+ * Le temps d'insertion et de recherche est rapporté pour chaque couple capacité des feuilles / profondeur maximale.
+ *
+ * @note Ce test est caché et doit être exécuté explicitement par la ligne de commande (avec -s pour voir les résultats)
+ */
+TEMPLATE_TEST_CASE("TQuadTree.8-QuadTree policy benchmark", "[.benchmark][policy]",
+  (TTestPolicy<0, std::numeric_limits<size_t>::max()>), (TTestPolicy<0, 8>), (TTestPolicy<0, 12>),
+  (TTestPolicy<4, std::numeric_limits<size_t>::max()>), (TTestPolicy<16, std::numeric_limits<size_t>::max()>),
+  (TTestPolicy<64, std::numeric_limits<size_t>::max()>), (TTestPolicy<16, 8>), (TTestPolicy<64, 8>),
+  (TInlinePolicy<0, 2>), (TInlinePolicy<16, 16>)) {
+  size_t depth;
+  size_t datasetSize;
+  std::vector<Rectangle> rectsAll = readRectangles(depth, datasetSize);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  TQuadTree<Rectangle, TestType> qt;
+  for (const auto& rect : rectsAll)
+    qt.insert(rect);
+  auto inserted = std::chrono::high_resolution_clock::now();
+  auto inscribed = qt.findInscribed(subDataLimits);
+  auto found = std::chrono::high_resolution_clock::now();
+  auto colliding = qt.findColliding(subDataLimits);
+  auto end = std::chrono::high_resolution_clock::now();
+
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+  SUCCEED("Bucket capacity: " << TestType::bucketCapacity << ", max depth: " << TestType::maxDepth
+    << ", inline capacity: " << TestType::inlineCapacity << "\n"
+    "Depth: " << qt.depth() << "\n"
+    "Insertion time: " << duration_cast<milliseconds>(inserted - start).count() << " ms\n"
+    "Finding time (container): " << duration_cast<milliseconds>(found - inserted).count() << " ms (" << inscribed.size() << " found)\n"
+    "Colliding time (container): " << duration_cast<milliseconds>(end - found).count() << " ms (" << colliding.size() << " found)\n");
+}
+
+/**
+ * @brief Benchmarke le QuadTree lâche face au QuadTree strict sur le jeu de données des tests de performance.
+ *
+ * La répartition des éléments par niveau et le temps des requêtes sont rapportés.
+ *
+ * @note Ce test est caché et doit être exécuté explicitement par la ligne de commande (avec -s pour voir les résultats)
+ */
+TEMPLATE_TEST_CASE("TQuadTree.10-Loose QuadTree benchmark", "[.benchmark][loose]", SQuadTreePolicy, SLoosePolicy, SLooseBucketPolicy) {
+  size_t depth;
+  size_t datasetSize;
+  std::vector<Rectangle> rectsAll = readRectangles(depth, datasetSize);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  TQuadTree<Rectangle, TestType> qt;
+  for (const auto& rect : rectsAll)
+    qt.insert(rect);
+  auto inserted = std::chrono::high_resolution_clock::now();
+  auto inscribed = qt.findInscribed(subDataLimits);
+  auto found = std::chrono::high_resolution_clock::now();
+  auto colliding = qt.findColliding(subDataLimits);
+  auto end = std::chrono::high_resolution_clock::now();
+
+  std::ostringstream levels;
+  for (size_t level = 0; auto size : qt.sizesByLevel())
+    levels << "  level " << ++level << ": " << size << "\n";
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  SUCCEED("Looseness: " << TestType::looseness << ", bucket capacity: " << TestType::bucketCapacity << "\n"
+    "Insertion time: " << duration_cast<microseconds>(inserted - start).count() << " us\n"
+    "Finding time (container): " << duration_cast<microseconds>(found - inserted).count() << " us (" << inscribed.size() << " found)\n"
+    "Colliding time (container): " << duration_cast<microseconds>(end - found).count() << " us (" << colliding.size() << " found)\n"
+    "Elements per level:\n" << levels.str());
+}
+
+/**
+ * @brief Benchmarke le chargement en masse face aux insertions successives sur le jeu de données des tests de performance.
+ *
+ * @note Ce test est caché et doit être exécuté explicitement par la ligne de commande (avec -s pour voir les résultats)
+ */
+TEST_CASE("TQuadTree.12-QuadTree bulk load benchmark", "[.benchmark][bulk]") {
+  size_t depth;
+  size_t datasetSize;
+  std::vector<Rectangle> rectsAll = readRectangles(depth, datasetSize);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  QuadTree inserted;
+  for (const auto& rect : rectsAll)
+    inserted.insert(rect);
+  auto middle = std::chrono::high_resolution_clock::now();
+  QuadTree loaded(rectsAll, { 0.0f, 0.0f, 1.0f, 1.0f });
+  auto end = std::chrono::high_resolution_clock::now();
+  REQUIRE(loaded.size() == inserted.size());
+  REQUIRE(loaded.depth() == depth);
+
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+  SUCCEED("Insertion time: " << duration_cast<milliseconds>(middle - start).count() << " ms\n"
+    "Bulk load time: " << duration_cast<milliseconds>(end - middle).count() << " ms\n");
+}
+
+/**
+ * @brief Benchmarke le débit des tests de limites de chaque jeu d'instructions supporté.
+ *
+ * Le débit est rapporté en millions de rectangles testés par seconde, chaque rectangle étant testé
+ * en collision puis en inclusion.
+ *
+ * @note Ce test est caché et doit être exécuté explicitement par la ligne de commande (avec -s pour voir les résultats)
+ */
+TEMPLATE_TEST_CASE("TQuadTree.15-QuadTree SIMD bounds benchmark", "[.benchmark][simd]", float, double, uint16_t) {
+  //Un tableau qui tient dans le cache : on mesure le calcul et non la bande passante mémoire
+  const size_t count = 1 << 14;
+  const int repeats = 3000;
+  auto bounds = randomBounds<TestType>(count, 0.01f, 15);
+  const TLimits<TestType> q = { toCoordinate<TestType>(subDataLimits.x1), toCoordinate<TestType>(subDataLimits.y1),
+                                toCoordinate<TestType>(subDataLimits.x2), toCoordinate<TestType>(subDataLimits.y2) };
+  const std::pair<ESimdLevel, const char*> levels[] = { { ESimdLevel::scalar, "scalar" }, { ESimdLevel::sse, "SSE" }, { ESimdLevel::avx, "AVX" } };
+
+  std::ostringstream report;
+  report << sizeof(TestType) * 8 << " bits\n";
+  std::vector<unsigned> colliding(bounds.blockCount()), inscribed(bounds.blockCount());
+  size_t expected = 0;
+  for (const auto& [level, name] : levels)
+  {
+    if (level > CSimd::supported())
+      continue;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int repeat = 0; repeat < repeats; repeat++)
+    {
+      bounds.collidingMasks(0, colliding.size(), q.x1, q.y1, q.x2, q.y2, colliding.data(), level);
+      bounds.inscribedMasks(0, inscribed.size(), q.x1, q.y1, q.x2, q.y2, inscribed.data(), level);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    size_t hits = 0;
+    for (size_t block = 0; block < bounds.blockCount(); block++)
+      hits += std::popcount(colliding[block]) + std::popcount(inscribed[block]);
+    if (level == ESimdLevel::scalar)
+      expected = hits;
+    REQUIRE(hits == expected);
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    report << name << ": " << static_cast<size_t>(2.0 * count * repeats / seconds / 1e6) << " Mboxes/s\n";
+  }
+  SUCCEED(report.str());
+}
+
+/**
+ * @brief Benchmarke les requêtes du QuadTree figé face à celles du QuadTree sur le jeu de données des tests de performance.
+ *
+ * @note Ce test est caché et doit être exécuté explicitement par la ligne de commande (avec -s pour voir les résultats)
+ */
+TEST_CASE("TQuadTree.31-Frozen QuadTree benchmark", "[.benchmark][frozen]") {
+  size_t depth;
+  size_t datasetSize;
+  std::vector<Rectangle> rectsAll = readRectangles(depth, datasetSize);
+  //Le jeu de données, ou beaucoup de petits rectangles
+  if (GENERATE(0, 1) == 1)
+    rectsAll = randomRectangles(1000000, 0.001f, 31);
+  QuadTree qt(rectsAll, { 0.0f, 0.0f, 1.0f, 1.0f });
+  auto start = std::chrono::high_resolution_clock::now();
+  TFrozenQuadTree frozen(qt);
+  auto built = std::chrono::high_resolution_clock::now();
+
+  //De petites requêtes, comme celles d'un service interrogé en continu
+  std::default_random_engine dre(31);
+  std::uniform_real_distribution<float> urd(0.0f, 0.98f);
+  std::vector<SLimits> queries;
+  for (int i = 0; i < 10000; i++)
+  {
+    const float x = urd(dre), y = urd(dre);
+    queries.push_back({ x, y, x + 0.001f, y + 0.001f });
+  }
+  size_t treeFound = 0, frozenFound = 0;
+  auto count = [](size_t& found) { return [&found](const Rectangle&) { ++found; }; };
+  auto treeStart = std::chrono::high_resolution_clock::now();
+  for (const auto& query : queries)
+    qt.forEachColliding(query, count(treeFound));
+  auto frozenStart = std::chrono::high_resolution_clock::now();
+  for (const auto& query : queries)
+    frozen.forEachColliding(query, count(frozenFound));
+  auto end = std::chrono::high_resolution_clock::now();
+  REQUIRE(frozenFound == treeFound);
+
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+  SUCCEED("Freezing time: " << duration_cast<milliseconds>(built - start).count() << " ms ("
+    << frozen.nodeCount() << " nodes, " << frozen.indexSize() / 1024 << " KiB index)\n"
+    "Colliding time (tree): " << duration_cast<milliseconds>(frozenStart - treeStart).count() << " ms (" << treeFound << " found)\n"
+    "Colliding time (frozen): " << duration_cast<milliseconds>(end - frozenStart).count() << " ms (" << frozenFound << " found)\n");
+}
+
+/**
+ * @brief Benchmarke le démarrage à partir d'un fichier projeté face à la reconstruction sur le jeu de données des tests de performance.
+ *
+ * @note Ce test est caché et doit être exécuté explicitement par la ligne de commande (avec -s pour voir les résultats)
+ */
+TEST_CASE("TQuadTree.33-Frozen QuadTree snapshot benchmark", "[.benchmark][snapshot]") {
+  const auto path = std::filesystem::temp_directory_path() / "TQuadTree.33.snapshot";
+  auto start = std::chrono::high_resolution_clock::now();
+  size_t depth;
+  size_t datasetSize;
+  std::vector<Rectangle> rectsAll = readRectangles(depth, datasetSize);
+  QuadTree qt(rectsAll, { 0.0f, 0.0f, 1.0f, 1.0f });
+  TFrozenQuadTree frozen(qt);
+  auto built = std::chrono::high_resolution_clock::now();
+  frozen.save(path);
+  auto saved = std::chrono::high_resolution_clock::now();
+  auto mapped = TFrozenQuadTree<Rectangle>::mapFile(path);
+  auto firstQuery = mapped.findColliding(subDataLimits);
+  auto end = std::chrono::high_resolution_clock::now();
+  REQUIRE(firstQuery.size() == frozen.findColliding(subDataLimits).size());
+  const auto fileSize = std::filesystem::file_size(path);
+  std::filesystem::remove(path);
+
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+  SUCCEED("Read and build time: " << duration_cast<milliseconds>(built - start).count() << " ms\n"
+    "Save time: " << duration_cast<milliseconds>(saved - built).count() << " ms (" << fileSize / 1024 << " KiB)\n"
+    "Map and first query time: " << duration_cast<milliseconds>(end - saved).count() << " ms\n");
+}
+
+/**
+ * @brief Benchmarke le chargement du jeu de données des tests de performance : lecture rectangle par rectangle face à la projection.
+ *
+ * @note Ce test est caché et doit être exécuté explicitement par la ligne de commande (avec -s pour voir les résultats)
+ */
+TEST_CASE("TQuadTree.35-Data set loader benchmark", "[.benchmark][dataset]") {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  auto start = std::chrono::high_resolution_clock::now();
+  size_t depth;
+  size_t datasetSize;
+  std::vector<Rectangle> rectsAll = readRectangles(depth, datasetSize);
+  auto read = std::chrono::high_resolution_clock::now();
+
+  //Projection, qui ne lit que le début du fichier, puis passage sur tous les enregistrements, tranche par tranche
+  CDataSet dataset(datasetFilename);
+  auto mapped = std::chrono::high_resolution_clock::now();
+  size_t valid = 0;
+  dataset.forEachChunk(4096, [&valid](std::span<const SDataSetRecord> chunk) {
+    for (const SDataSetRecord& record : chunk)
+      valid += record.x1() <= record.x2() && record.y1() <= record.y2();
+    });
+  auto scanned = std::chrono::high_resolution_clock::now();
+
+  std::vector<Rectangle> rectsMapped(dataset.as<Rectangle>().begin(), dataset.as<Rectangle>().end());
+  auto copied = std::chrono::high_resolution_clock::now();
+
+  QuadTree qtRead(rectsAll, { 0.0f, 0.0f, 1.0f, 1.0f });
+  auto builtRead = std::chrono::high_resolution_clock::now();
+  QuadTree qtMapped(dataset.as<Rectangle>(), { 0.0f, 0.0f, 1.0f, 1.0f });
+  auto builtMapped = std::chrono::high_resolution_clock::now();
+
+  //Format version 2 : métadonnées lues dans l'en-tête, tranches vérifiées en parallèle
+  const auto path = std::filesystem::temp_directory_path() / "TQuadTree.35.dat";
+  CDataSet::save(path, dataset.records(), { 0.0f, 0.0f, 1.0f, 1.0f }, dataset.depth());
+  auto saved = std::chrono::high_resolution_clock::now();
+  CDataSet chunked(path);
+  auto opened = std::chrono::high_resolution_clock::now();
+  std::vector<std::future<bool>> checks;
+  for (size_t chunk = 0; chunk < chunked.chunkCount(); chunk++)
+    checks.push_back(std::async(std::launch::async, [&chunked, chunk]() { return chunked.checkChunk(chunk); }));
+  const bool verified = std::all_of(checks.begin(), checks.end(), [](std::future<bool>& check) { return check.get(); });
+  auto checked = std::chrono::high_resolution_clock::now();
+  REQUIRE(verified);
+  REQUIRE(chunked.records().size() == dataset.size());
+  REQUIRE(chunked.distribution().maxWidth == dataset.distribution().maxWidth);
+  std::filesystem::remove(path);
+
+  REQUIRE(dataset.size() == datasetSize);
+  REQUIRE(dataset.depth() == depth);
+  REQUIRE(rectsMapped == rectsAll);
+  REQUIRE(qtMapped.size() == qtRead.size());
+  REQUIRE(valid == datasetSize);
+
+  const double bytes = static_cast<double>(dataset.size() * sizeof(SDataSetRecord));
+  auto rate = [bytes](auto duration) { return bytes / std::max<long long>(duration_cast<microseconds>(duration).count(), 1) / 1000.0; };
+  SUCCEED("readDataSet: " << duration_cast<microseconds>(read - start).count() / 1000 << " ms (" << rate(read - start) << " GB/s)\n"
+    "Open version 1: " << duration_cast<microseconds>(mapped - read).count() << " us\n"
+    "Scan: " << duration_cast<microseconds>(scanned - mapped).count() / 1000 << " ms (" << rate(scanned - mapped) << " GB/s)\n"
+    "Copy to rectangles: " << duration_cast<microseconds>(copied - scanned).count() / 1000 << " ms (" << rate(copied - scanned) << " GB/s)\n"
+    "Build from read rectangles: " << duration_cast<microseconds>(builtRead - copied).count() / 1000 << " ms\n"
+    "Build from mapped records: " << duration_cast<microseconds>(builtMapped - builtRead).count() / 1000 << " ms\n"
+    "Save version 2: " << duration_cast<microseconds>(saved - builtMapped).count() / 1000 << " ms\n"
+    "Open version 2: " << duration_cast<microseconds>(opened - saved).count() << " us\n"
+    "Check " << chunked.chunkCount() << " chunks in parallel: " << duration_cast<microseconds>(checked - opened).count() / 1000 << " ms (" << rate(checked - opened) << " GB/s)\n");
+}
+
+/**
+ * @brief Benchmarke le comptage face à la récupération des éléments sur le jeu de données des tests de performance.
+ *
+ * @note Ce test est caché et doit être exécuté explicitement par la ligne de commande (avec -s pour voir les résultats)
+ */
+TEST_CASE("TQuadTree.38-QuadTree count benchmark", "[.benchmark][count]") {
+  CDataSet dataset(datasetFilename);
+  QuadTree qt(dataset.as<Rectangle>(), { 0.0f, 0.0f, 1.0f, 1.0f });
+  const float size = GENERATE(0.01f, 0.1f, 0.5f);
+  std::default_random_engine dre(38);
+  std::uniform_real_distribution<float> urd(0.0f, 1.0f - size);
+  std::vector<SLimits> queries;
+  for (int i = 0; i < 100; i++)
+  {
+    const float x = urd(dre), y = urd(dre);
+    queries.push_back({ x, y, x + size, y + size });
+  }
+
+  size_t found = 0, counted = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (const SLimits& limits : queries)
+    found += qt.findColliding(limits).size();
+  auto middle = std::chrono::high_resolution_clock::now();
+  for (const SLimits& limits : queries)
+    counted += qt.countColliding(limits);
+  auto end = std::chrono::high_resolution_clock::now();
+  REQUIRE(counted == found);
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  SUCCEED("Query size " << size << ", " << found / queries.size() << " elements per query\n"
+    "findColliding: " << duration_cast<microseconds>(middle - start).count() / queries.size() << " us per query\n"
+    "countColliding: " << duration_cast<microseconds>(end - middle).count() / queries.size() << " us per query\n");
+}
+
+/**
+ * @brief Benchmarke les requêtes d'une vue dézoomée, qui couvre presque tout le QuadTree, sur le jeu de données des tests de performance.
+ *
+ * @note Ce test est caché et doit être exécuté explicitement par la ligne de commande (avec -s pour voir les résultats)
+ */
+TEST_CASE("TQuadTree.40-QuadTree covered subtrees benchmark", "[.benchmark][cover]") {
+  CDataSet dataset(datasetFilename);
+  QuadTree qt(dataset.as<Rectangle>(), { 0.0f, 0.0f, 1.0f, 1.0f });
+  const SLimits view = GENERATE(SLimits{ -0.5f, -0.5f, 1.5f, 1.5f }, SLimits{ 0.05f, 0.05f, 0.95f, 0.95f });
+
+  auto start = std::chrono::high_resolution_clock::now();
+  size_t found = 0;
+  for (int i = 0; i < 10; i++)
+    found += qt.findColliding(view).size();
+  auto copied = std::chrono::high_resolution_clock::now();
+  size_t visited = 0;
+  for (int i = 0; i < 10; i++)
+    qt.forEachColliding(view, [&visited](const Rectangle&) { ++visited; });
+  auto end = std::chrono::high_resolution_clock::now();
+  REQUIRE(visited == found);
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  SUCCEED("View " << view.x1 << ", " << view.y1 << ", " << view.x2 << ", " << view.y2 << ": " << found / 10 << " elements\n"
+    "findColliding: " << duration_cast<microseconds>(copied - start).count() / 10 << " us per query\n"
+    "forEachColliding: " << duration_cast<microseconds>(end - copied).count() / 10 << " us per query\n");
+}
+
+/**
+ * @brief Benchmarke le pointage à la souris sur les rectangles de la démonstration Particules.
+ *
+ * @note Ce test est caché et doit être exécuté explicitement par la ligne de commande (avec -s pour voir les résultats)
+ */
+TEST_CASE("TQuadTree.42-QuadTree point query benchmark", "[.benchmark][containing]") {
+  auto rects = randomRectangles(100000, 0.05f, 42);
+  QuadTree qt(rects, { 0.0f, 0.0f, 1.0f, 1.0f });
+  std::default_random_engine dre(42);
+  std::uniform_real_distribution<float> urd(0.0f, 1.0f);
+  std::vector<std::pair<float, float>> points;
+  for (int i = 0; i < 100000; i++)
+    points.emplace_back(urd(dre), urd(dre));
+
+  size_t colliding = 0, containing = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (auto [x, y] : points)
+    colliding += qt.findColliding({ x, y, x, y }).size();
+  auto middle = std::chrono::high_resolution_clock::now();
+  for (auto [x, y] : points)
+    qt.forEachContaining(x, y, [&containing](const Rectangle&) { ++containing; });
+  auto end = std::chrono::high_resolution_clock::now();
+  REQUIRE(containing == colliding);
+
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  SUCCEED(containing / points.size() << " elements per point\n"
+    "findColliding: " << duration_cast<nanoseconds>(middle - start).count() / points.size() << " ns per point\n"
+    "forEachContaining: " << duration_cast<nanoseconds>(end - middle).count() / points.size() << " ns per point\n");
+}
+
+/**
+ * @brief Benchmarke la recherche des k plus proches voisins face à un parcours de tous les éléments, sur le jeu de données des tests de performance.
+ *
+ * @note Ce test est caché et doit être exécuté explicitement par la ligne de commande (avec -s pour voir les résultats)
+ */
+TEST_CASE("TQuadTree.44-QuadTree nearest neighbors benchmark", "[.benchmark][nearest]") {
+  CDataSet dataset(datasetFilename);
+  QuadTree qt(dataset.as<Rectangle>(), { 0.0f, 0.0f, 1.0f, 1.0f });
+  const size_t k = GENERATE(1, 10, 100);
+  std::default_random_engine dre(44);
+  std::uniform_real_distribution<float> urd(0.0f, 1.0f);
+  std::vector<std::pair<float, float>> points;
+  for (int i = 0; i < 1000; i++)
+    points.emplace_back(urd(dre), urd(dre));
+
+  std::vector<const Rectangle*> nearest;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (auto [x, y] : points)
+  {
+    nearest.clear();
+    qt.findNearest(x, y, k, nearest, SCentroidDistance());
+  }
+  auto middle = std::chrono::high_resolution_clock::now();
+  //Parcours de tous les éléments, sur quelques points seulement
+  float last = 0.0f;
+  auto all = qt.getAll();
+  for (size_t i = 0; i < 10; i++)
+  {
+    auto [x, y] = points[i];
+    std::vector<float> distances;
+    distances.reserve(all.size());
+    for (const Rectangle& r : all)
+      distances.push_back(SCentroidDistance()(SLimits{ r.x1(), r.y1(), r.x2(), r.y2() }, x, y));
+    std::nth_element(distances.begin(), distances.begin() + (k - 1), distances.end());
+    last = distances[k - 1];
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  REQUIRE(nearest.size() == k);
+  REQUIRE(SCentroidDistance()(SLimits{ nearest.back()->x1(), nearest.back()->y1(), nearest.back()->x2(), nearest.back()->y2() },
+    points.back().first, points.back().second) >= 0.0f);
+  REQUIRE(last >= 0.0f);
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  SUCCEED("k = " << k << "\n"
+    "findNearest: " << duration_cast<microseconds>(middle - start).count() / points.size() << " us per point\n"
+    "Scan of all elements: " << duration_cast<microseconds>(end - middle).count() / 10 << " us per point\n");
+}
+
+/**
+ * @brief Benchmarke une vue tournée et un disque face à la requête sur leur rectangle englobant suivie d'un filtrage,
+ * sur le jeu de données des tests de performance.
+ *
+ * @note Ce test est caché et doit être exécuté explicitement par la ligne de commande (avec -s pour voir les résultats)
+ */
+TEST_CASE("TQuadTree.47-QuadTree shape query benchmark", "[.benchmark][shape]") {
+  CDataSet dataset(datasetFilename);
+  QuadTree qt(dataset.as<Rectangle>(), { 0.0f, 0.0f, 1.0f, 1.0f });
+  const bool rotated = GENERATE(false, true);
+  std::default_random_engine dre(47);
+  std::uniform_real_distribution<float> position(0.2f, 0.8f);
+  std::uniform_real_distribution<float> angle(0.0f, std::numbers::pi_v<float>);
+  std::vector<TConvexPolygon<>> views;
+  std::vector<TCircle<>> circles;
+  for (int i = 0; i < 100; i++)
+  {
+    views.push_back(TConvexPolygon<>::rotatedRectangle(position(dre), position(dre), 0.3f, 0.2f, angle(dre)));
+    circles.push_back({ position(dre), position(dre), 0.15f });
+  }
+
+  auto benchmark = [&qt](const auto& shapes)
+  {
+    std::vector<Rectangle> filtered;
+    std::vector<const Rectangle*> exact;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& shape : shapes)
+    {
+      filtered.clear();
+      for (const Rectangle& r : qt.findColliding(SLimits{ shape.x1(), shape.y1(), shape.x2(), shape.y2() }))
+        if (shape.intersects(SLimits{ r.x1(), r.y1(), r.x2(), r.y2() }))
+          filtered.push_back(r);
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    for (const auto& shape : shapes)
+    {
+      exact.clear();
+      qt.findColliding(shape, exact);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    REQUIRE(exact.size() == filtered.size());
+    return std::pair(middle - start, end - middle);
+  };
+  const auto [filter, exact] = rotated ? benchmark(views) : benchmark(circles);
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  SUCCEED((rotated ? "Rotated viewport" : "Circle") << "\n"
+    "findColliding on the bounding box, then filter: " << duration_cast<microseconds>(filter).count() / 100 << " us per query\n"
+    "findColliding on the shape: " << duration_cast<microseconds>(exact).count() / 100 << " us per query\n");
+}
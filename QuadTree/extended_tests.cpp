@@ -0,0 +1,1642 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <random>
+#include <string>
+#include <memory_resource>
+#include <numbers>
+
+#include "test_fixtures.h"
+#include "TFrozenQuadTree.h"
+#include "CDataSet.h"
+
+/**
+ * @brief Ressource mémoire qui compte les allocations transmises à la ressource par défaut.
+ */
+class CCountingResource : public std::pmr::memory_resource
+{
+  size_t m_Allocations = 0;
+
+  void* do_allocate(size_t bytes, size_t alignment) override
+  {
+    ++m_Allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override
+  {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+  {
+    return this == &other;
+  }
+
+public:
+  size_t allocations() const { return m_Allocations; }
+};
+
+/**
+ * @brief Teste le QuadTree alloué dans une std::pmr::memory_resource.
+ *
+ * Ce test vérifie qu'un cycle vidage puis reconstruction n'alloue plus rien auprès du système
+ * une fois la mémoire rendue à un pool.
+ */
+TEST_CASE("TQuadTree.6-QuadTree allocator test", "[allocator]") {
+  auto rects = randomRectangles(1000, 0.01f, 6);
+  CCountingResource upstream;
+  std::pmr::unsynchronized_pool_resource pool(&upstream);
+  TPmrQuadTree<Rectangle> qt({ 0.0f, 0.0f, 1.0f, 1.0f }, &pool);
+  REQUIRE(qt.get_allocator().resource() == &pool);
+
+  for (const auto& rect : rects)
+    qt.insert(rect);
+  REQUIRE(sorted(qt.getAll()) == sorted(rects));
+
+  //Deux cycles pour atteindre le régime établi, puis plus aucune allocation auprès du système
+  for (int cycle = 0; cycle < 2; cycle++)
+  {
+    qt.clear();
+    for (const auto& rect : rects)
+      qt.insert(rect);
+  }
+  size_t allocations = upstream.allocations();
+  qt.clear();
+  REQUIRE(qt.empty());
+  for (const auto& rect : rects)
+    qt.insert(rect);
+  REQUIRE(qt.size() == rects.size());
+  REQUIRE(upstream.allocations() == allocations);
+
+  //Les copies sont allouées entièrement dans une arène : sans ressource par défaut, aucune liste ne peut lui échapper
+  std::pmr::unsynchronized_pool_resource other(std::pmr::new_delete_resource());
+  auto handle = qt.insertWithHandle(Rectangle(0.1f, 0.1f, 0.2f, 0.2f));
+  std::pmr::memory_resource* pDefault = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  try
+  {
+    TPmrQuadTree<Rectangle> copy(qt);
+    REQUIRE(copy.get_allocator().resource() == &pool);
+    TPmrQuadTree<Rectangle> assigned({ 0.0f, 0.0f, 1.0f, 1.0f }, &other);
+    assigned.insert(Rectangle(0.5f, 0.5f, 0.6f, 0.6f));
+    assigned = copy;
+    REQUIRE(assigned.get_allocator().resource() == &other);
+    TPmrQuadTree<Rectangle> extended(qt, &other);
+    REQUIRE(extended.get_allocator().resource() == &other);
+    for (const TPmrQuadTree<Rectangle>* pCopy : { &copy, &assigned, &extended })
+    {
+      REQUIRE(pCopy->size() == rects.size() + 1);
+      REQUIRE(pCopy->at(handle) == Rectangle(0.1f, 0.1f, 0.2f, 0.2f));
+    }
+    //Les listes copiées continuent de grandir dans l'arène
+    for (const auto& rect : rects)
+      assigned.insert(rect);
+    REQUIRE(assigned.size() == 2 * rects.size() + 1);
+  }
+  catch (...)
+  {
+    std::pmr::set_default_resource(pDefault);
+    throw;
+  }
+  std::pmr::set_default_resource(pDefault);
+}
+
+/**
+ * @brief Teste les requêtes de chaque politique face à la recherche exhaustive, après insertions puis retraits.
+ *
+ * Les politiques de subdivision limitent en outre la profondeur : les feuilles ne sont subdivisées qu'au débordement,
+ * et jamais au-delà de la profondeur maximale.
+ */
+TEMPLATE_LIST_TEST_CASE("TQuadTree.7-QuadTree policy test", "[policy]", QuadTreePolicies) {
+  TRandomTree<TestType> fixture(2000, 0.1f, 7);
+  auto& [qt, rects, handles] = fixture;
+  checkRandomQueries(qt, rects, 7);
+  if constexpr (TestType::maxDepth != std::numeric_limits<size_t>::max())
+    REQUIRE(qt.depth() <= TestType::maxDepth);
+  //Sans capacité de feuilles, les plus petits éléments atteignent la profondeur maximale
+  if constexpr (TestType::maxDepth != std::numeric_limits<size_t>::max() && TestType::bucketCapacity == 0)
+    REQUIRE(qt.depth() == TestType::maxDepth);
+  if constexpr (TestType::bucketCapacity != 0 && TestType::looseness == 1.0f)
+    REQUIRE(qt.depth() <= QuadTree(rects, { 0.0f, 0.0f, 1.0f, 1.0f }).depth());
+
+  checkRandomQueries(qt, fixture.removeHalf(), 7);
+}
+
+/**
+ * @brief Teste le QuadTree lâche.
+ *
+ * Ce test vérifie que les éléments descendent au niveau correspondant à leur taille, y compris ceux qui chevauchent
+ * les médianes. Les requêtes des politiques lâches sont vérifiées avec celles des autres politiques (voir le test 7).
+ */
+TEST_CASE("TQuadTree.9-Loose QuadTree test", "[loose]") {
+  TQuadTree<Rectangle, SLoosePolicy> qt;
+  //Un petit rectangle centré sur le centre de la surface reste à la racine d'un QuadTree strict
+  qt.insert(Rectangle(0.49f, 0.49f, 0.51f, 0.51f));
+  REQUIRE(qt.depth() > 2);
+  auto levels = qt.sizesByLevel();
+  REQUIRE(levels.size() == qt.depth());
+  REQUIRE(levels.back() == 1);
+  REQUIRE(qt.findColliding({ 0.505f, 0.505f, 0.6f, 0.6f }).size() == 1);
+  REQUIRE(qt.findColliding({ 0.52f, 0.0f, 1.0f, 1.0f }).empty());
+  REQUIRE(qt.findInscribed({ 0.4f, 0.4f, 0.6f, 0.6f }).size() == 1);
+  qt.remove(Rectangle(0.49f, 0.49f, 0.51f, 0.51f));
+  REQUIRE(qt.empty());
+}
+
+/**
+ * @brief Teste le chargement en masse du QuadTree.
+ *
+ * Sans capacité de feuilles, un QuadTree chargé en masse est identique au même QuadTree construit par insertions successives.
+ */
+TEMPLATE_LIST_TEST_CASE("TQuadTree.11-QuadTree bulk load test", "[bulk]", QuadTreePolicies) {
+  using QT = TQuadTree<Rectangle, TestType>;
+  TRandomTree<TestType> fixture(5000, 0.1f, 11);
+  auto& [inserted, rects, handles] = fixture;
+  //Quelques rectangles minuscules qui descendent très profondément
+  for (Rectangle tiny : { Rectangle(0.3f, 0.3f, 0.3f, 0.3f), Rectangle(0.7f, 0.2f, 0.7f + 1e-7f, 0.2f + 1e-7f) })
+  {
+    inserted.insert(tiny);
+    rects.push_back(tiny);
+  }
+
+  QT loaded(rects, { 0.0f, 0.0f, 1.0f, 1.0f });
+  REQUIRE(loaded.size() == inserted.size());
+  //Avec une capacité de feuilles, la forme obtenue par insertions successives dépend de l'ordre d'insertion
+  if constexpr (TestType::bucketCapacity == 0)
+  {
+    REQUIRE(loaded.depth() == inserted.depth());
+    REQUIRE(loaded.sizesByLevel() == inserted.sizesByLevel());
+  }
+  checkRandomQueries(loaded, rects, 11);
+  std::vector<Rectangle> kept;
+  for (size_t i = 0; i < rects.size(); i++)
+  {
+    if (i % 3 == 0)
+      loaded.remove(rects[i]);
+    else
+      kept.push_back(rects[i]);
+  }
+  checkRandomQueries(loaded, kept, 11);
+
+  SECTION("assign") {
+    QT qt;
+    qt.insert(Rectangle(0.0f, 0.0f, 1.0f, 1.0f));
+    //Une liste chaînée n'est pas indexable : ses éléments sont recopiés avant le chargement
+    std::list<Rectangle> list(rects.begin(), rects.end());
+    qt.assign(list);
+    checkQueries(qt, rects, subDataLimits);
+    //Un élément hors limites laisse le QuadTree inchangé
+    if constexpr (!TestType::growable)
+    {
+      list.emplace_back(0.5f, 0.5f, 1.5f, 1.5f);
+      REQUIRE_THROWS_AS(qt.assign(list), std::domain_error);
+      checkQueries(qt, rects, subDataLimits);
+    }
+    qt.assign(std::vector<Rectangle>());
+    REQUIRE(qt.empty());
+    REQUIRE(qt.depth() == 1);
+  }
+}
+
+/**
+ * @brief Teste la cohérence des limites recopiées dans les noeuds avec leurs éléments.
+ *
+ * Tous les rectangles chevauchent les médianes et restent à la racine : leurs limites remplissent plusieurs blocs,
+ * et les retraits en font passer la taille par chaque bordure de bloc.
+ */
+TEST_CASE("TQuadTree.13-QuadTree element bounds test", "[bounds]") {
+  std::vector<Rectangle> rects;
+  for (size_t i = 0; i < 3 * TBoundsArray<>::width + 3; i++)
+  {
+    float offset = static_cast<float>(i) / 100.0f;
+    rects.emplace_back(0.2f + offset, 0.45f, 0.55f + offset, 0.55f);
+  }
+  QuadTree qt;
+  for (const auto& rect : rects)
+    qt.insert(rect);
+  REQUIRE(qt.depth() == 1);
+
+  const SLimits limits = { 0.0f, 0.0f, 0.6f, 0.6f };
+  std::default_random_engine dre(13);
+  while (!rects.empty())
+  {
+    checkQueries(qt, rects, limits);
+    //Retire un rectangle quelconque : il est remplacé par le dernier de la liste
+    size_t index = std::uniform_int_distribution<size_t>(0, rects.size() - 1)(dre);
+    qt.remove(rects[index]);
+    rects.erase(rects.begin() + index);
+  }
+  checkQueries(qt, rects, limits);
+  REQUIRE(qt.empty());
+}
+
+/**
+ * @brief Teste les tests de limites de chaque jeu d'instructions supporté face au code standard.
+ *
+ * Le dernier bloc est incomplet : ses emplacements inutilisés ne doivent jamais satisfaire un test.
+ */
+TEMPLATE_TEST_CASE("TQuadTree.14-QuadTree SIMD bounds test", "[simd]", float, double, uint16_t) {
+  auto bounds = randomBounds<TestType>(1000 * TBoundsArray<TestType>::width + 5, 0.3f, 14);
+  auto c = [](float value) { return toCoordinate<TestType>(value); };
+  const SLimits queries[] = { subDataLimits, { 0.0f, 0.0f, 1.0f, 1.0f }, { 0.5f, 0.5f, 0.5f, 0.5f }, { 2.0f, 2.0f, 3.0f, 3.0f } };
+  const ESimdLevel levels[] = { ESimdLevel::sse, ESimdLevel::avx };
+
+  for (ESimdLevel level : levels)
+  {
+    if (level > CSimd::supported())
+      continue;
+    for (const SLimits& q : queries)
+    {
+      std::vector<unsigned> masks(bounds.blockCount()), expected(bounds.blockCount());
+      bounds.collidingMasks(0, bounds.blockCount(), c(q.x1), c(q.y1), c(q.x2), c(q.y2), masks.data(), level);
+      bounds.collidingMasks(0, bounds.blockCount(), c(q.x1), c(q.y1), c(q.x2), c(q.y2), expected.data(), ESimdLevel::scalar);
+      REQUIRE(masks == expected);
+      bounds.inscribedMasks(0, bounds.blockCount(), c(q.x1), c(q.y1), c(q.x2), c(q.y2), masks.data(), level);
+      bounds.inscribedMasks(0, bounds.blockCount(), c(q.x1), c(q.y1), c(q.x2), c(q.y2), expected.data(), ESimdLevel::scalar);
+      REQUIRE(masks == expected);
+    }
+    const size_t last = bounds.blockCount() - 1;
+    unsigned mask;
+    bounds.collidingMasks(last, 1, c(-1.0f), c(-1.0f), c(2.0f), c(2.0f), &mask, level);
+    REQUIRE(mask == bounds.usedMask(last));
+    bounds.inscribedMasks(last, 1, c(-1.0f), c(-1.0f), c(2.0f), c(2.0f), &mask, level);
+    REQUIRE(mask == bounds.usedMask(last));
+  }
+
+  //Le QuadTree donne les mêmes résultats quel que soit le jeu d'instructions
+  auto rects = randomRectangles(5000, 0.1f, 14);
+  QuadTree qt(rects, { 0.0f, 0.0f, 1.0f, 1.0f });
+  const ESimdLevel active = CSimd::active();
+  CSimd::select(ESimdLevel::scalar);
+  checkQueries(qt, rects, subDataLimits);
+  CSimd::select(active);
+  checkQueries(qt, rects, subDataLimits);
+}
+
+/**
+ * @brief Teste les requêtes par visiteur, et leur interruption.
+ *
+ * Les visiteurs sont vérifiés face à la recherche exhaustive avec les autres formes de requêtes (voir checkQuery).
+ */
+TEST_CASE("TQuadTree.16-QuadTree visitor test", "[visitor]") {
+  auto rects = randomRectangles(3000, 0.1f, 16);
+  QuadTree qt(rects, { 0.0f, 0.0f, 1.0f, 1.0f });
+  const TBruteForce oracle(rects);
+  checkQueries(qt, oracle, subDataLimits);
+
+  //Une fonction qui retourne true poursuit le parcours
+  std::vector<Rectangle> visited;
+  REQUIRE(qt.forEachInscribed(subDataLimits, [&visited](const Rectangle& r) { visited.push_back(r); return true; }));
+  REQUIRE(sorted(visited) == oracle.inscribed(subDataLimits));
+
+  //Le parcours s'arrête dès que la fonction retourne false
+  REQUIRE(visited.size() > 10);
+  size_t count = 0;
+  REQUIRE_FALSE(qt.forEachInscribed(subDataLimits, [&count](const Rectangle&) { return ++count < 10; }));
+  REQUIRE(count == 10);
+
+  //Aucun élément trouvé : la fonction n'est jamais appelée
+  REQUIRE(qt.forEachColliding({ 2.0f, 2.0f, 3.0f, 3.0f }, [](const Rectangle&) { FAIL(); return false; }));
+}
+
+/**
+ * @brief Teste les requêtes qui remplissent une destination fournie par l'appelant.
+ *
+ * Les résultats sont vérifiés face à la recherche exhaustive avec les autres formes de requêtes (voir checkQuery) :
+ * ce test vérifie ce qui est propre aux destinations.
+ */
+TEST_CASE("TQuadTree.17-QuadTree output buffer test", "[buffer]") {
+  auto rects = randomRectangles(3000, 0.1f, 17);
+  QuadTree qt(rects, { 0.0f, 0.0f, 1.0f, 1.0f });
+  const TBruteForce oracle(rects);
+  checkQueries(qt, oracle, subDataLimits);
+
+  SECTION("output iterator") {
+    std::vector<Rectangle> all;
+    qt.getAll(std::back_inserter(all));
+    REQUIRE(sorted(all) == oracle.all());
+
+    //Un itérateur de sortie quelconque, vers un tableau déjà dimensionné
+    const std::vector<Rectangle> colliding = oracle.colliding(subDataLimits);
+    std::vector<Rectangle> array(colliding.size(), Rectangle(0.0f, 0.0f, 0.0f, 0.0f));
+    REQUIRE(qt.findColliding(subDataLimits, array.begin()) == array.end());
+    REQUIRE(sorted(array) == colliding);
+  }
+
+  SECTION("pointers") {
+    std::vector<const Rectangle*> pointers;
+    qt.getAll(pointers);
+    REQUIRE(sorted(dereferenced(pointers)) == oracle.all());
+
+    //La liste n'est pas vidée : l'appelant la réutilise
+    pointers.clear();
+    qt.findInscribed(subDataLimits, pointers);
+    const size_t inscribed = pointers.size();
+    REQUIRE(inscribed == oracle.inscribed(subDataLimits).size());
+    qt.findInscribed(subDataLimits, pointers);
+    REQUIRE(pointers.size() == 2 * inscribed);
+
+    //Les adresses désignent le stockage du QuadTree
+    pointers.clear();
+    qt.findColliding(subDataLimits, pointers);
+    for (const Rectangle* p : pointers)
+      REQUIRE(std::find_if(qt.begin(), qt.end(), [p](const Rectangle& r) { return &r == p; }) != qt.end());
+  }
+}
+
+/**
+ * @brief Teste les identifiants stables : accès, retrait et mise à jour sans recherche.
+ */
+TEMPLATE_LIST_TEST_CASE("TQuadTree.18-QuadTree handle test", "[handle]", QuadTreePolicies) {
+  using QT = TQuadTree<Rectangle, TestType>;
+  TRandomTree<TestType> fixture(3000, 0.1f, 18);
+  auto& [qt, rects, handles] = fixture;
+  //Les éléments insérés sans identifiant cohabitent avec les autres
+  auto others = randomRectangles(500, 0.1f, 180);
+  for (const auto& rect : others)
+    qt.insert(rect);
+  for (size_t i = 0; i < rects.size(); i++)
+    REQUIRE(qt.at(handles[i]) == rects[i]);
+
+  //Retire un élément sur trois par son identifiant
+  std::vector<typename QT::handle> removed;
+  std::vector<Rectangle> kept = others;
+  for (size_t i = 0; i < rects.size(); i++)
+  {
+    if (i % 3 == 0)
+    {
+      REQUIRE(qt.remove(handles[i]));
+      removed.push_back(handles[i]);
+    }
+    else
+      kept.push_back(rects[i]);
+  }
+  checkQueries(qt, kept, subDataLimits);
+  for (auto h : removed)
+  {
+    REQUIRE_FALSE(qt.contains(h));
+    REQUIRE_FALSE(qt.remove(h));
+    REQUIRE_THROWS_AS(qt.at(h), std::out_of_range);
+  }
+
+  //Les emplacements libérés sont réutilisés sans rendre valides les anciens identifiants
+  auto reinserted = qt.insertWithHandle(rects.front());
+  kept.push_back(rects.front());
+  REQUIRE(qt.at(reinserted) == rects.front());
+  REQUIRE_FALSE(qt.contains(removed.front()));
+
+  //Déplace les éléments restants, petits déplacements et sauts à travers tout le QuadTree
+  std::default_random_engine dre(18);
+  std::uniform_real_distribution<float> urd(-0.02f, 0.02f);
+  kept = others;
+  kept.push_back(rects.front());
+  for (size_t i = 0; i < rects.size(); i++)
+  {
+    if (i % 3 == 0)
+      continue;
+    const Rectangle& r = rects[i];
+    float dx = i % 5 == 0 ? 0.5f - r.x2() : urd(dre);
+    float dy = i % 5 == 0 ? 0.5f - r.y2() : urd(dre);
+    dx = std::clamp(dx, -r.x1(), 1.0f - r.x2());
+    dy = std::clamp(dy, -r.y1(), 1.0f - r.y2());
+    Rectangle moved(r.x1() + dx, r.y1() + dy, r.x2() + dx, r.y2() + dy);
+    REQUIRE(qt.update(handles[i], moved));
+    REQUIRE(qt.at(handles[i]) == moved);
+    kept.push_back(moved);
+  }
+  checkQueries(qt, kept, subDataLimits);
+  REQUIRE_FALSE(qt.update(removed.back(), rects.back()));
+  if constexpr (!TestType::growable)
+    REQUIRE_THROWS_AS(qt.update(handles[1], Rectangle(0.5f, 0.5f, 1.5f, 1.5f)), std::domain_error);
+  REQUIRE(qt.at(handles[1]) == kept[others.size() + 1]);
+
+  //Un retrait par égalité rend aussi l'identifiant invalide, et le vidage tous les identifiants
+  qt.remove(qt.at(handles[1]));
+  REQUIRE_FALSE(qt.contains(handles[1]));
+  REQUIRE(qt.contains(handles[2]));
+  qt.clear();
+  REQUIRE_FALSE(qt.contains(handles[2]));
+  REQUIRE_FALSE(qt.contains(reinserted));
+}
+
+/**
+ * @brief Teste le déplacement d'éléments animés, avec et sans marge.
+ */
+TEMPLATE_LIST_TEST_CASE("TQuadTree.19-QuadTree relocate test", "[relocate]", QuadTreePolicies) {
+  TRandomTree<TestType> fixture(2000, 0.05f, 19);
+  auto& [qt, rects, handles] = fixture;
+
+  std::default_random_engine dre(19);
+  std::uniform_real_distribution<float> urd(-0.005f, 0.005f);
+  auto moved = [&dre, &urd](const Rectangle& r) {
+    float dx = std::clamp(urd(dre), -r.x1(), 1.0f - r.x2());
+    float dy = std::clamp(urd(dre), -r.y1(), 1.0f - r.y2());
+    return Rectangle(r.x1() + dx, r.y1() + dy, r.x2() + dx, r.y2() + dy);
+    };
+
+  SECTION("with margin") {
+    for (int step = 0; step < 30; step++)
+    {
+      for (size_t i = 0; i < rects.size(); i++)
+      {
+        rects[i] = moved(rects[i]);
+        REQUIRE(qt.relocate(handles[i], rects[i], 0.02f));
+      }
+      if (step % 10 == 0)
+        checkQueries(qt, rects, subDataLimits);
+    }
+    checkQueries(qt, rects, subDataLimits);
+
+    //Un déplacement qui reste dans la zone agrandie ne modifie pas la structure
+    auto sizes = qt.sizesByLevel();
+    Rectangle r = rects.front();
+    REQUIRE(qt.relocate(handles.front(), Rectangle(r.x1(), r.y1(), r.x2(), r.y2()), 0.02f));
+    auto depth = qt.depth();
+    for (size_t i = 0; i < rects.size(); i++)
+      REQUIRE(qt.relocate(handles[i], rects[i], 0.02f));
+    REQUIRE(qt.sizesByLevel() == sizes);
+    REQUIRE(qt.depth() == depth);
+
+    //Après un déplacement sur place, l'élément stocké n'est plus égal à sa valeur d'avant : un retrait par cette valeur
+    //ne trouve rien et ne modifie pas le QuadTree, le retrait par identifiant retire l'élément
+    const Rectangle previous = rects.front();
+    rects.front() = moved(previous);
+    REQUIRE_FALSE(rects.front() == previous);
+    REQUIRE(qt.relocate(handles.front(), rects.front(), 0.02f));
+    REQUIRE(qt.sizesByLevel() == sizes);
+    qt.remove(previous);
+    REQUIRE(qt.size() == rects.size());
+    REQUIRE(qt.at(handles.front()) == rects.front());
+    REQUIRE(qt.remove(handles.front()));
+    REQUIRE_FALSE(qt.contains(handles.front()));
+    REQUIRE(qt.size() == rects.size() - 1);
+    REQUIRE_FALSE(qt.remove(handles.front()));
+    handles.front() = qt.insertWithHandle(rects.front());
+
+    //Les éléments déplacés se retirent par leur identifiant
+    for (size_t i = 0; i < rects.size(); i += 2)
+      REQUIRE(qt.remove(handles[i]));
+    std::vector<Rectangle> kept;
+    for (size_t i = 1; i < rects.size(); i += 2)
+      kept.push_back(rects[i]);
+    checkQueries(qt, kept, subDataLimits);
+  }
+
+  SECTION("without margin") {
+    for (int step = 0; step < 10; step++)
+      for (size_t i = 0; i < rects.size(); i++)
+      {
+        Rectangle next = moved(rects[i]);
+        if (i % 2)
+          REQUIRE(qt.relocate(handles[i], next));
+        else
+          REQUIRE(qt.relocate(rects[i], next));
+        rects[i] = next;
+      }
+    checkQueries(qt, rects, subDataLimits);
+    for (size_t i = 0; i < rects.size(); i++)
+      REQUIRE(qt.at(handles[i]) == rects[i]);
+
+    //Sans marge, un élément déplacé est toujours retrouvé par égalité
+    for (size_t i = 0; i < rects.size(); i += 2)
+      qt.remove(rects[i]);
+    REQUIRE(qt.size() == rects.size() / 2);
+    REQUIRE_FALSE(qt.relocate(rects[0], rects[1]));
+    if constexpr (!TestType::growable)
+      REQUIRE_THROWS_AS(qt.relocate(handles[1], Rectangle(0.9f, 0.9f, 1.1f, 1.1f)), std::domain_error);
+  }
+}
+
+/**
+ * @brief Teste la fusion des enfants devenus (presque) vides après des retraits.
+ */
+TEMPLATE_LIST_TEST_CASE("TQuadTree.20-QuadTree collapse test", "[collapse]", QuadTreePolicies) {
+  using QT = TQuadTree<Rectangle, TestType>;
+  TRandomTree<TestType> fixture(5000, 0.1f, 20);
+  auto& [qt, rects, handles] = fixture;
+  const size_t depth = qt.depth();
+
+  //Retire neuf éléments sur dix, par identifiant ou par égalité
+  std::vector<Rectangle> kept;
+  for (size_t i = 0; i < rects.size(); i++)
+  {
+    if (i % 10 == 0)
+      kept.push_back(rects[i]);
+    else if (i % 2 == 0)
+      REQUIRE(qt.remove(handles[i]));
+    else
+      qt.remove(rects[i]);
+  }
+  checkQueries(qt, kept, subDataLimits);
+  REQUIRE(qt.depth() <= depth);
+  for (size_t i = 0; i < rects.size(); i += 10)
+    REQUIRE(qt.at(handles[i]) == rects[i]);
+  //Sans capacité de feuilles, le QuadTree est le même que s'il avait été construit avec les seuls éléments restants
+  if constexpr (TestType::bucketCapacity == 0)
+  {
+    QT reference(kept, { 0.0f, 0.0f, 1.0f, 1.0f });
+    REQUIRE(qt.sizesByLevel() == reference.sizesByLevel());
+    REQUIRE(qt.depth() == reference.depth());
+  }
+
+  //Une fois vide, le QuadTree est réduit à sa racine, puis les noeuds libérés sont réutilisés
+  for (size_t i = 0; i < rects.size(); i += 10)
+    REQUIRE(qt.remove(handles[i]));
+  REQUIRE(qt.empty());
+  REQUIRE(qt.depth() == 1);
+  REQUIRE(qt.sizesByLevel() == std::vector<size_t>{ 0 });
+  for (int cycle = 0; cycle < 3; cycle++)
+  {
+    handles.clear();
+    for (const auto& rect : rects)
+      handles.push_back(qt.insertWithHandle(rect));
+    REQUIRE(qt.depth() == depth);
+    checkQueries(qt, rects, subDataLimits);
+    for (auto h : handles)
+      REQUIRE(qt.remove(h));
+    REQUIRE(qt.depth() == 1);
+  }
+}
+
+/**
+ * @brief Teste l'hystérésis de la fusion : une feuille subdivisée n'est fusionnée qu'à la moitié de sa capacité.
+ */
+TEST_CASE("TQuadTree.21-QuadTree collapse hysteresis test", "[collapse]") {
+  TQuadTree<Rectangle, TTestPolicy<8, std::numeric_limits<size_t>::max()>> qt;
+  std::vector<Rectangle> rects;
+  for (int i = 0; i < 9; i++)
+    rects.push_back(Rectangle((i % 4) * 0.25f + 0.01f, (i % 4) * 0.25f + 0.01f + i * 0.001f,
+                              (i % 4) * 0.25f + 0.02f, (i % 4) * 0.25f + 0.02f + i * 0.001f));
+  for (const auto& rect : rects)
+    qt.insert(rect);
+  REQUIRE(qt.sizesByLevel() == std::vector<size_t>{ 0, 9 });
+
+  //Repasser sous la capacité ne suffit pas à fusionner les enfants
+  qt.remove(rects[8]);
+  REQUIRE(qt.sizesByLevel() == std::vector<size_t>{ 0, 8 });
+  qt.insert(rects[8]);
+  REQUIRE(qt.sizesByLevel() == std::vector<size_t>{ 0, 9 });
+  for (int i = 8; i > 4; i--)
+    qt.remove(rects[i]);
+  REQUIRE(qt.sizesByLevel() == std::vector<size_t>{ 0, 5 });
+  qt.remove(rects[4]);
+  REQUIRE(qt.sizesByLevel() == std::vector<size_t>{ 4 });
+  REQUIRE(qt.depth() == 1);
+  checkQueries(qt, std::vector<Rectangle>(rects.begin(), rects.begin() + 4), subDataLimits);
+}
+
+/**
+ * @brief Teste l'agrandissement de la racine et l'insertion sans exception.
+ */
+TEMPLATE_TEST_CASE("TQuadTree.22-QuadTree growable root test", "[grow]", SGrowablePolicy, SLooseGrowablePolicy) {
+  using QT = TQuadTree<Rectangle, TestType>;
+  TRandomTree<TestType> fixture(2000, 0.1f, 22);
+  auto& [qt, rects, handles] = fixture;
+  const size_t depth = qt.depth();
+
+  //Des éléments de plus en plus loin, dans toutes les directions
+  std::vector<Rectangle> all = rects;
+  for (int i = 1; i <= 8; i++)
+  {
+    const float d = static_cast<float>(1 << i);
+    for (Rectangle r : { Rectangle(-d, -d, -d + 0.05f, -d + 0.05f), Rectangle(d, 0.5f, d + 0.05f, 0.55f),
+                         Rectangle(0.5f, d, 0.55f, d + 0.05f), Rectangle(-d, d, -d + 0.5f, d + 0.5f) })
+    {
+      REQUIRE(qt.tryInsert(r));
+      all.push_back(r);
+    }
+  }
+  const SLimits limits = qt.limits();
+  REQUIRE(limits.x1 <= -256.0f);
+  REQUIRE(limits.y2 >= 256.5f);
+  REQUIRE(qt.depth() > depth);
+  checkQueries(qt, all, subDataLimits);
+  checkQueries(qt, all, { -100.0f, -100.0f, 100.0f, 100.0f });
+  for (size_t i = 0; i < rects.size(); i++)
+    REQUIRE(qt.at(handles[i]) == rects[i]);
+
+  //Sans capacité de feuilles, le QuadTree est le même que s'il avait été construit d'emblée avec ses limites finales
+  QT reference(limits);
+  for (const auto& rect : all)
+    reference.insert(rect);
+  if constexpr (TestType::bucketCapacity == 0)
+    REQUIRE(qt.sizesByLevel() == reference.sizesByLevel());
+
+  //Les déplacements et les retraits agrandissent ou parcourent aussi le QuadTree agrandi
+  REQUIRE(qt.relocate(handles[0], Rectangle(1000.0f, 1000.0f, 1000.5f, 1000.5f), 0.01f));
+  all[0] = qt.at(handles[0]);
+  REQUIRE(qt.limits().x2 >= 1000.5f);
+  for (size_t i = rects.size(); i < all.size(); i++)
+    qt.remove(all[i]);
+  all.resize(rects.size());
+  checkQueries(qt, all, { -100.0f, -100.0f, 100.0f, 100.0f });
+
+  //Seuls les éléments dont les limites ne sont pas finies sont rejetés
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float inf = std::numeric_limits<float>::infinity();
+  REQUIRE_FALSE(qt.tryInsert(Rectangle(nan, 0.0f, 0.1f, 0.1f)));
+  REQUIRE_FALSE(qt.tryInsert(Rectangle(0.0f, 0.0f, inf, 0.1f)));
+  REQUIRE_THROWS_AS(qt.insert(Rectangle(-inf, 0.0f, 0.1f, 0.1f)), std::domain_error);
+  REQUIRE(qt.size() == all.size());
+
+  //Le chargement en bloc agrandit la racine une seule fois pour tous les éléments
+  QT bulk(all, { 0.0f, 0.0f, 1.0f, 1.0f });
+  REQUIRE(bulk.limits().x2 >= 1000.5f);
+  checkQueries(bulk, all, { -100.0f, -100.0f, 2000.0f, 2000.0f });
+}
+
+/**
+ * @brief Teste l'insertion sans exception dans un QuadTree qui ne peut pas s'agrandir.
+ */
+TEST_CASE("TQuadTree.23-QuadTree tryInsert test", "[grow]") {
+  auto rects = randomRectangles(1000, 0.1f, 23);
+  TQuadTree<Rectangle> qt;
+  for (const auto& rect : rects)
+    REQUIRE(qt.tryInsert(rect));
+  auto sizes = qt.sizesByLevel();
+  REQUIRE_FALSE(qt.tryInsert(Rectangle(0.5f, 0.5f, 1.5f, 0.6f)));
+  REQUIRE_FALSE(qt.tryInsert(Rectangle(-0.1f, 0.5f, 0.1f, 0.6f)));
+  REQUIRE(qt.limits() == SLimits{ 0.0f, 0.0f, 1.0f, 1.0f });
+  REQUIRE(qt.sizesByLevel() == sizes);
+  checkQueries(qt, rects, subDataLimits);
+}
+
+/**
+ * @brief Rectangle en coordonnées double, pour un QuadTree couvrant un monde étendu.
+ */
+struct SWideRectangle
+{
+  double m_x1, m_y1, m_x2, m_y2;
+
+  double x1() const { return m_x1; }
+  double y1() const { return m_y1; }
+  double x2() const { return m_x2; }
+  double y2() const { return m_y2; }
+
+  bool operator==(const SWideRectangle& other) const = default;
+  std::partial_ordering operator<=>(const SWideRectangle& other) const = default;
+};
+
+/**
+ * @brief Politique d'un QuadTree en coordonnées double, avec limites compressées.
+ */
+struct SDoubleQuantizedPolicy : SQuadTreePolicy
+{
+  using coordinate = double;
+  static constexpr bool quantized = true;
+};
+
+/**
+ * @brief Teste un QuadTree en coordonnées double, sur un monde où la précision des float ne suffit plus.
+ */
+TEMPLATE_TEST_CASE("TQuadTree.24-QuadTree double coordinates test", "[coordinate]", SDoublePolicy, SDoubleQuantizedPolicy) {
+  using QT = TQuadTree<SWideRectangle, TestType>;
+  static_assert(std::is_same_v<typename QT::limits_type, TLimits<double>>);
+  const double world = 1.0e8;
+  std::default_random_engine dre(24);
+  std::uniform_real_distribution<double> urd(0.0, 1.0);
+  //Des rectangles de quelques unités dans un monde de 10^8 unités : les float ne distinguent pas leurs bords
+  std::vector<SWideRectangle> rects;
+  for (int i = 0; i < 5000; i++)
+  {
+    const double x = urd(dre) * (world - 10.0), y = urd(dre) * (world - 10.0);
+    rects.push_back({ x, y, x + 1.0 + urd(dre), y + 1.0 + urd(dre) });
+  }
+  QT qt({ 0.0, 0.0, world, world });
+  for (const auto& rect : rects)
+    qt.insert(rect);
+  const TBruteForce oracle(rects);
+  checkQueries(qt, oracle, qt.limits());
+  //Requêtes autour d'un rectangle existant, dont les bords tombent entre deux float
+  for (int i = 0; i < 50; i++)
+  {
+    const SWideRectangle& r = rects[i * 97];
+    checkQuery(qt, oracle, TLimits<double>{ r.x1() - 0.25, r.y1() - 0.25, r.x2() + 0.25, r.y2() + 0.25 });
+  }
+  for (const auto& rect : rects)
+    qt.remove(rect);
+  REQUIRE(qt.empty());
+  REQUIRE(qt.depth() == 1);
+}
+
+/**
+ * @brief Politique d'un QuadTree lâche avec une capacité de feuilles et des limites compressées.
+ */
+struct SLooseQuantizedPolicy : SQuadTreePolicy
+{
+  static constexpr float looseness = 2.0f;
+  static constexpr size_t bucketCapacity = 16;
+  static constexpr bool quantized = true;
+};
+
+/**
+ * @brief Teste les limites compressées : les requêtes ne doivent manquer aucun élément ni en retenir en trop.
+ */
+TEMPLATE_TEST_CASE("TQuadTree.25-QuadTree quantized bounds test", "[quantized]", SQuantizedPolicy, SLooseQuantizedPolicy) {
+  TRandomTree<TestType> fixture(20000, 0.05f, 25);
+  auto& [qt, rects, handles] = fixture;
+
+  //Requêtes dont les bords coïncident avec ceux d'éléments, où l'arrondi des limites compressées compte
+  std::vector<SLimits> queries = { subDataLimits, { 0.0f, 0.0f, 1.0f, 1.0f }, { 0.5f, 0.5f, 0.5f, 0.5f } };
+  for (size_t i = 0; i < 20; i++)
+  {
+    const Rectangle& r = rects[i * 13];
+    queries.push_back({ r.x1(), r.y1(), r.x2(), r.y2() });
+    queries.push_back({ r.x2(), r.y2(), r.x2() + 0.1f, r.y2() + 0.1f });
+  }
+  const TBruteForce oracle(rects);
+  const ESimdLevel active = CSimd::active();
+  for (ESimdLevel level : { ESimdLevel::scalar, active })
+  {
+    CSimd::select(level);
+    for (const auto& q : queries)
+      checkQuery(qt, oracle, q);
+  }
+  CSimd::select(active);
+
+  //Les limites compressées suivent les éléments déplacés, retirés ou remontés par une fusion
+  std::default_random_engine dre(25);
+  std::uniform_real_distribution<float> urd(-0.01f, 0.01f);
+  std::vector<Rectangle> kept;
+  for (size_t i = 0; i < rects.size(); i++)
+  {
+    if (i % 4 == 0)
+    {
+      qt.remove(handles[i]);
+      continue;
+    }
+    const Rectangle& r = rects[i];
+    const float dx = std::clamp(urd(dre), -r.x1(), 1.0f - r.x2());
+    const float dy = std::clamp(urd(dre), -r.y1(), 1.0f - r.y2());
+    Rectangle moved(r.x1() + dx, r.y1() + dy, r.x2() + dx, r.y2() + dy);
+    qt.relocate(handles[i], moved, i % 2 == 0 ? 0.01f : 0.0f);
+    kept.push_back(moved);
+  }
+  const TBruteForce relocated(kept);
+  checkQueries(qt, relocated, qt.limits());
+  for (const auto& q : queries)
+    checkQuery(qt, relocated, q);
+}
+
+/**
+ * @brief Rectangle portant un libellé : ses copies et ses déplacements ne sont pas triviaux.
+ */
+struct SLabelledRectangle
+{
+  Rectangle rect;
+  std::string label;
+
+  float x1() const { return rect.x1(); }
+  float y1() const { return rect.y1(); }
+  float x2() const { return rect.x2(); }
+  float y2() const { return rect.y2(); }
+
+  bool operator==(const SLabelledRectangle& other) const = default;
+};
+
+/**
+ * @brief Teste la liste à éléments stockés dans l'objet, au-delà et en deçà de sa capacité.
+ */
+TEST_CASE("TQuadTree.26-QuadTree small vector test", "[inline]") {
+  using SmallVector = TSmallVector<std::string, 3, std::pmr::polymorphic_allocator<std::string>>;
+  CCountingResource upstream;
+  //Des libellés trop longs pour l'optimisation des petites chaînes : un déplacement raté se verrait
+  auto label = [](int i) { return std::string(40, 'a' + static_cast<char>(i)); };
+
+  SmallVector v(&upstream);
+  for (int i = 0; i < 3; i++)
+    v.push_back(label(i));
+  REQUIRE(v.size() == 3);
+  REQUIRE(v.capacity() == 3);
+  REQUIRE(upstream.allocations() == 0);
+  //Un élément de la liste elle-même peut être ajouté lorsqu'elle déborde
+  v.push_back(v[0]);
+  v.emplace_back(10, 'z');
+  REQUIRE(v.size() == 5);
+  REQUIRE(v.capacity() >= 5);
+  REQUIRE(upstream.allocations() == 1);
+  REQUIRE(v[3] == label(0));
+  REQUIRE(v.back() == std::string(10, 'z'));
+
+  SmallVector copy(v);
+  REQUIRE(std::equal(copy.begin(), copy.end(), v.begin(), v.end()));
+  const auto data = v.data();
+  SmallVector moved(std::move(v));
+  REQUIRE(moved.data() == data);
+  REQUIRE(v.empty());
+  v = copy;
+  REQUIRE(std::equal(copy.begin(), copy.end(), v.begin(), v.end()));
+  while (v.size() > 2)
+    v.pop_back();
+  SmallVector small(std::move(v));
+  REQUIRE(small.size() == 2);
+  REQUIRE(small[1] == label(1));
+
+  //Entre deux ressources différentes, les éléments sont déplacés un à un
+  std::pmr::monotonic_buffer_resource other;
+  SmallVector foreign(&other);
+  foreign = std::move(copy);
+  REQUIRE(foreign.size() == 5);
+  REQUIRE(foreign[4] == std::string(10, 'z'));
+  REQUIRE(foreign.get_allocator().resource() == &other);
+  foreign.clear();
+  REQUIRE(foreign.empty());
+}
+
+/**
+ * @brief Teste un QuadTree dont les noeuds stockent leurs premiers éléments en eux-mêmes.
+ */
+TEMPLATE_TEST_CASE("TQuadTree.27-QuadTree inline storage test", "[inline]", (TInlinePolicy<0, 2>), (TInlinePolicy<16, 4>)) {
+  TRandomTree<TestType> fixture(5000, 0.1f, 27);
+  auto& [qt, rects, handles] = fixture;
+  checkRandomQueries(qt, rects, 27);
+  const TBruteForce kept(fixture.removeHalf());
+  checkRandomQueries(qt, kept, 27);
+  auto copy = qt;
+  checkRandomQueries(copy, kept, 27);
+
+  //Éléments non triviaux, dans une ressource qui compte les allocations
+  CCountingResource upstream;
+  TPmrQuadTree<SLabelledRectangle, TestType> labelled({ 0.0f, 0.0f, 1.0f, 1.0f }, &upstream);
+  std::vector<SLabelledRectangle> items;
+  for (size_t i = 0; i < 1000; i++)
+    items.push_back({ rects[i], std::to_string(i) });
+  std::vector<typename TPmrQuadTree<SLabelledRectangle, TestType>::handle> labelledHandles;
+  for (const auto& item : items)
+    labelledHandles.push_back(labelled.insertWithHandle(item));
+  for (size_t i = 0; i < items.size(); i += 3)
+    REQUIRE(labelled.remove(labelledHandles[i]));
+  for (size_t i = 1; i < items.size(); i += 3)
+    REQUIRE(labelled.at(labelledHandles[i]) == items[i]);
+  REQUIRE(labelled.size() == items.size() - (items.size() + 2) / 3);
+
+  //Les noeuds peu remplis n'allouent pas leur liste : moins d'allocations qu'avec des std::vector
+  CCountingResource vectorUpstream;
+  TPmrQuadTree<SLabelledRectangle, TTestPolicy<TestType::bucketCapacity, std::numeric_limits<size_t>::max()>> reference(
+    { 0.0f, 0.0f, 1.0f, 1.0f }, &vectorUpstream);
+  const size_t before = upstream.allocations();
+  labelled.clear();
+  for (const auto& item : items)
+    labelled.insert(item);
+  for (const auto& item : items)
+    reference.insert(item);
+  REQUIRE(upstream.allocations() - before < vectorUpstream.allocations());
+}
+
+/**
+ * @brief Rectangle portant une donnée allouée, qui compte ses copies.
+ *
+ * Le concept QuadTreeData exige des éléments copiables : le compteur vérifie que le QuadTree n'en copie aucun
+ * lorsqu'ils lui sont confiés par déplacement. Un élément déplacé perd sa donnée.
+ */
+struct SCountedRectangle
+{
+  Rectangle rect;
+  std::unique_ptr<int> payload;
+  inline static size_t copies = 0;
+
+  SCountedRectangle(const Rectangle& r, int value)
+    : rect(r), payload(std::make_unique<int>(value))
+  {
+  }
+  SCountedRectangle(const SCountedRectangle& other)
+    : rect(other.rect), payload(other.payload ? std::make_unique<int>(*other.payload) : nullptr)
+  {
+    ++copies;
+  }
+  SCountedRectangle(SCountedRectangle&& other) noexcept = default;
+  SCountedRectangle& operator=(const SCountedRectangle& other)
+  {
+    rect = other.rect;
+    payload = other.payload ? std::make_unique<int>(*other.payload) : nullptr;
+    ++copies;
+    return *this;
+  }
+  SCountedRectangle& operator=(SCountedRectangle&& other) noexcept = default;
+
+  float x1() const { return rect.x1(); }
+  float y1() const { return rect.y1(); }
+  float x2() const { return rect.x2(); }
+  float y2() const { return rect.y2(); }
+
+  bool operator==(const SCountedRectangle& other) const
+  {
+    return rect == other.rect && (payload ? other.payload && *payload == *other.payload : !other.payload);
+  }
+};
+
+/**
+ * @brief Vérifie que les éléments confiés par déplacement au QuadTree ne sont jamais copiés.
+ */
+TEST_CASE("TQuadTree.28-QuadTree element move test", "[move]") {
+  auto rects = randomRectangles(2000, 0.05f, 28);
+  SCountedRectangle::copies = 0;
+  TQuadTree<SCountedRectangle, TTestPolicy<4, std::numeric_limits<size_t>::max()>> qt;
+  std::vector<TQuadTree<SCountedRectangle, TTestPolicy<4, std::numeric_limits<size_t>::max()>>::handle> handles;
+  for (int i = 0; i < static_cast<int>(rects.size()); i++)
+  {
+    if (i % 3 == 0)
+      qt.insert(SCountedRectangle(rects[i], i));
+    else if (i % 3 == 1)
+      qt.emplace(rects[i], i);
+    else
+      handles.push_back(qt.insertWithHandle(SCountedRectangle(rects[i], i)));
+  }
+  REQUIRE(qt.size() == rects.size());
+
+  //Un élément rejeté n'est pas déplacé
+  SCountedRectangle outside(Rectangle(2.0f, 2.0f, 3.0f, 3.0f), -1);
+  REQUIRE_FALSE(qt.tryInsert(std::move(outside)));
+  REQUIRE(outside.payload != nullptr);
+  REQUIRE_THROWS_AS(qt.insert(std::move(outside)), std::domain_error);
+  REQUIRE(outside.payload != nullptr);
+
+  //Remplacements sur place et rangements à nouveau, avec et sans marge
+  std::default_random_engine dre(28);
+  std::uniform_real_distribution<float> urd(0.0f, 0.9f);
+  for (size_t i = 0; i < handles.size(); i++)
+  {
+    const float x = urd(dre), y = urd(dre);
+    SCountedRectangle moved(Rectangle(x, y, x + 0.01f, y + 0.01f), -static_cast<int>(i));
+    if (i % 2 == 0)
+      REQUIRE(qt.update(handles[i], std::move(moved)));
+    else
+      REQUIRE(qt.relocate(handles[i], std::move(moved), 0.01f));
+    REQUIRE(*qt.at(handles[i]).payload == -static_cast<int>(i));
+  }
+
+  //Chaque élément a gardé sa donnée, et les requêtes trouvent tous les éléments
+  size_t count = 0;
+  long long sum = 0;
+  qt.forEachColliding({ 0.0f, 0.0f, 1.0f, 1.0f }, [&](const SCountedRectangle& r) { ++count; sum += *r.payload; });
+  long long expected = 0;
+  for (int i = 0; i < static_cast<int>(rects.size()); i++)
+    expected += i % 3 == 2 ? 0 : i;
+  for (size_t i = 0; i < handles.size(); i++)
+    expected -= static_cast<long long>(i);
+  REQUIRE(count == rects.size());
+  REQUIRE(sum == expected);
+  for (size_t i = 0; i < handles.size(); i += 2)
+    REQUIRE(qt.remove(handles[i]));
+  REQUIRE(qt.size() == rects.size() - (handles.size() + 1) / 2);
+  REQUIRE(SCountedRectangle::copies == 0);
+}
+
+/**
+ * @brief Teste le déplacement et l'échange de QuadTree entiers.
+ */
+TEST_CASE("TQuadTree.29-QuadTree move and swap test", "[move]") {
+  auto rects = randomRectangles(3000, 0.05f, 29);
+  std::vector<Rectangle> firstHalf(rects.begin(), rects.begin() + rects.size() / 2);
+  std::vector<Rectangle> secondHalf(rects.begin() + rects.size() / 2, rects.end());
+  TQuadTree<Rectangle> qt({ 0.0f, 0.0f, 1.0f, 1.0f });
+  std::vector<TQuadTree<Rectangle>::handle> handles;
+  for (const auto& rect : firstHalf)
+    handles.push_back(qt.insertWithHandle(rect));
+
+  //Le déplacement reprend les noeuds sans toucher aux éléments, et sans rien allouer
+  static_assert(std::is_nothrow_move_constructible_v<QuadTree>);
+  static_assert(std::is_nothrow_move_assignable_v<QuadTree>);
+  const Rectangle* pFirst = &*qt.begin();
+  TQuadTree<Rectangle> moved(std::move(qt));
+  REQUIRE(&*moved.begin() == pFirst);
+  REQUIRE(moved.at(handles[0]) == firstHalf[0]);
+  checkQueries(moved, firstHalf, subDataLimits);
+  //La source reste utilisable : vide, avec les limites par défaut
+  REQUIRE(qt.empty());
+  REQUIRE(qt.size() == 0);
+  REQUIRE(qt.limits() == SLimits{ 0.0f, 0.0f, 1.0f, 1.0f });
+  REQUIRE(qt.depth() == 1);
+  REQUIRE(qt.sizesByLevel() == std::vector<size_t>{ 0 });
+  REQUIRE_FALSE(qt.contains(handles[0]));
+  REQUIRE(qt.begin() == qt.end());
+  REQUIRE(qt.findColliding({ 0.0f, 0.0f, 1.0f, 1.0f }).empty());
+  REQUIRE(qt.findContaining(0.5f, 0.5f).empty());
+  REQUIRE(qt.findNearest(0.5f, 0.5f, 3).empty());
+  REQUIRE(qt.countColliding(TQuadTree<Rectangle>::circle_type{ 0.5f, 0.5f, 1.0f }) == 0);
+  REQUIRE(TFrozenQuadTree<Rectangle>(qt).empty());
+  qt.remove(firstHalf[0]);
+  REQUIRE_FALSE(qt.remove(handles[0]));
+  REQUIRE_FALSE(qt.update(handles[0], firstHalf[1]));
+  REQUIRE_FALSE(qt.relocate(handles[0], firstHalf[1], 0.01f));
+  REQUIRE_FALSE(qt.relocate(firstHalf[0], firstHalf[1]));
+  REQUIRE(qt.empty());
+  TQuadTree<Rectangle> copied(qt);
+  REQUIRE(copied.empty());
+  for (const auto& rect : secondHalf)
+    qt.insert(rect);
+  checkQueries(qt, secondHalf, subDataLimits);
+
+  //L'échange suit les éléments, identifiants compris
+  swap(qt, moved);
+  checkQueries(qt, firstHalf, subDataLimits);
+  checkQueries(moved, secondHalf, subDataLimits);
+  REQUIRE(qt.at(handles[1]) == firstHalf[1]);
+
+  pFirst = &*qt.begin();
+  moved = std::move(qt);
+  REQUIRE(&*moved.begin() == pFirst);
+  checkQueries(moved, firstHalf, subDataLimits);
+  REQUIRE(qt.empty());
+  REQUIRE(qt.depth() == 1);
+  moved = std::move(moved);
+  checkQueries(moved, firstHalf, subDataLimits);
+
+  //Une liste de QuadTree qui grandit les déplace au lieu de les copier
+  std::vector<TQuadTree<Rectangle>> trees(1);
+  trees[0].insert(firstHalf[0]);
+  pFirst = &*trees[0].begin();
+  trees.resize(trees.capacity() + 1);
+  REQUIRE(&*trees[0].begin() == pFirst);
+
+  //Entre deux ressources différentes, les éléments sont déplacés dans des noeuds alloués avec la ressource de la destination,
+  //et chaque QuadTree garde la sienne : sans ressource par défaut, aucune liste ne peut lui échapper
+  CCountingResource first, second;
+  TPmrQuadTree<Rectangle> a({ 0.0f, 0.0f, 1.0f, 1.0f }, &first), b({ 0.0f, 0.0f, 1.0f, 1.0f }, &second);
+  for (const auto& rect : firstHalf)
+    a.insert(rect);
+  std::pmr::memory_resource* pDefault = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  try
+  {
+    b = std::move(a);
+    REQUIRE(b.get_allocator().resource() == &second);
+    REQUIRE(a.empty());
+    checkQueries(b, firstHalf, subDataLimits);
+    TPmrQuadTree<Rectangle> c(std::move(b));
+    REQUIRE(c.get_allocator().resource() == &second);
+    checkQueries(c, firstHalf, subDataLimits);
+    //Les sources vidées retrouvent une racine dans leur propre ressource
+    a.insert(firstHalf[0]);
+    b.insert(firstHalf[1]);
+    REQUIRE(a.size() == 1);
+    REQUIRE(b.size() == 1);
+  }
+  catch (...)
+  {
+    std::pmr::set_default_resource(pDefault);
+    throw;
+  }
+  std::pmr::set_default_resource(pDefault);
+}
+
+/**
+ * @brief Teste le QuadTree figé, avec chaque politique et après des retraits.
+ *
+ * Un QuadTree figé a la profondeur et les limites de son origine, et ses requêtes en donnent les éléments.
+ */
+TEMPLATE_LIST_TEST_CASE("TQuadTree.30-Frozen QuadTree test", "[frozen]", QuadTreePolicies) {
+  auto checkFrozen = [](const auto& qt, const TBruteForce<>& oracle, unsigned int seed) {
+    TFrozenQuadTree frozen(qt);
+    REQUIRE(frozen.depth() == qt.depth());
+    REQUIRE(frozen.limits() == qt.limits());
+    checkRandomQueries(frozen, oracle, seed);
+    };
+  checkFrozen(TQuadTree<Rectangle, TestType>(), std::vector<Rectangle>(), 30);
+  TRandomTree<TestType> fixture(10000, 0.05f, 30);
+  auto& [qt, rects, handles] = fixture;
+  checkFrozen(qt, rects, 31);
+
+  //Après des retraits, des sous-arbres vides restent et des groupes d'enfants sont réutilisés hors de l'ordre des niveaux
+  std::vector<Rectangle> kept = fixture.removeHalf();
+  for (size_t i = 0; i < rects.size(); i += 4)
+  {
+    qt.insert(rects[i]);
+    kept.push_back(rects[i]);
+  }
+  checkFrozen(qt, kept, 32);
+
+  //Le QuadTree figé est indépendant de son origine
+  TFrozenQuadTree frozen(qt);
+  const size_t size = qt.size();
+  qt.clear();
+  REQUIRE(frozen.size() == size);
+  std::vector<const Rectangle*> pointers;
+  frozen.findColliding(subDataLimits, pointers);
+  std::vector<Rectangle> copied;
+  frozen.findColliding(subDataLimits, std::back_inserter(copied));
+  REQUIRE(pointers.size() == copied.size());
+  for (size_t i = 0; i < pointers.size(); i++)
+    REQUIRE(*pointers[i] == copied[i]);
+  size_t visited = 0;
+  REQUIRE_FALSE(frozen.forEachInscribed({ 0.0f, 0.0f, 1.0f, 1.0f }, [&visited](const Rectangle&) { return ++visited < 10; }));
+  REQUIRE(visited == 10);
+}
+
+/**
+ * @brief Teste l'enregistrement d'un QuadTree figé et sa projection en mémoire.
+ */
+TEST_CASE("TQuadTree.32-Frozen QuadTree snapshot test", "[snapshot]") {
+  const auto path = std::filesystem::temp_directory_path() / "TQuadTree.32.snapshot";
+  auto rects = randomRectangles(10000, 0.05f, 32);
+  QuadTree qt(rects, { 0.0f, 0.0f, 1.0f, 1.0f });
+  TFrozenQuadTree frozen(qt);
+  frozen.save(path);
+
+  const TBruteForce oracle(rects);
+  {
+    auto mapped = TFrozenQuadTree<Rectangle>::mapFile(path);
+    REQUIRE(mapped.size() == frozen.size());
+    REQUIRE(mapped.depth() == frozen.depth());
+    REQUIRE(mapped.limits() == frozen.limits());
+    REQUIRE(mapped.nodeCount() == frozen.nodeCount());
+    REQUIRE(mapped.getAll() == frozen.getAll());
+    checkRandomQueries(mapped, oracle, 32);
+    //Une copie partage la projection, qui survit à l'original
+    auto copy = mapped;
+    mapped = TFrozenQuadTree<Rectangle>();
+    REQUIRE(mapped.empty());
+    checkQueries(copy, oracle, subDataLimits);
+  }
+
+  //Un QuadTree figé vide s'enregistre aussi
+  TFrozenQuadTree<Rectangle>().save(path);
+  auto empty = TFrozenQuadTree<Rectangle>::mapFile(path);
+  REQUIRE(empty.empty());
+  REQUIRE(empty.findColliding({ 0.0f, 0.0f, 1.0f, 1.0f }).empty());
+
+  //Fichiers corrompus avec un en-tête valide : l'en-tête donne la position des noeuds (voir TFrozenQuadTree::SFileHeader)
+  frozen.save(path);
+  std::vector<char> bytes(std::filesystem::file_size(path));
+  std::ifstream(path, std::ios::binary).read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  uint64_t indexOffset;
+  std::memcpy(&indexOffset, bytes.data() + 56, sizeof(indexOffset));
+  auto mapCorrupted = [&](size_t offset, auto value) {
+    std::vector<char> corrupted = bytes;
+    std::memcpy(corrupted.data() + offset, &value, sizeof(value));
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(corrupted.data(), static_cast<std::streamsize>(corrupted.size()));
+    return TFrozenQuadTree<Rectangle>::mapFile(path);
+  };
+  REQUIRE(frozen.nodeCount() > 8);
+  for (size_t node = 0; node < 8; node++)
+    for (size_t field = 0; field < 3; field++)
+    {
+      //L'octet de poids fort de firstChild, firstElement ou elementCount
+      const size_t offset = static_cast<size_t>(indexOffset) + node * 12 + field * 4 + 3;
+      REQUIRE_THROWS_AS(mapCorrupted(offset, static_cast<char>(bytes[offset] ^ 0x7f)), std::runtime_error);
+    }
+  //Un enfant qui désigne un ancêtre ferait boucler les parcours
+  auto firstChildOf = [&](size_t node) {
+    uint32_t firstChild;
+    std::memcpy(&firstChild, bytes.data() + indexOffset + node * 12, sizeof(firstChild));
+    return firstChild;
+  };
+  size_t parent = 1;
+  while (firstChildOf(parent) == UINT32_MAX)
+    parent++;
+  REQUIRE_THROWS_AS(mapCorrupted(static_cast<size_t>(indexOffset + parent * 12), uint32_t(1)), std::runtime_error);
+  //Une profondeur fausse est rejetée, une taille de pile fausse est ignorée
+  REQUIRE_THROWS_AS(mapCorrupted(88, uint64_t(frozen.depth() + 1)), std::runtime_error);
+  auto hugeStack = mapCorrupted(96, uint64_t(1) << 40);
+  checkQueries(hugeStack, oracle, subDataLimits);
+  hugeStack = TFrozenQuadTree<Rectangle>();
+
+  //Fichiers absents, tronqués, ou écrits pour un autre type d'éléments
+  frozen.save(path);
+  using SWideFrozenQuadTree = TFrozenQuadTree<SWideRectangle, SDoublePolicy>;
+  REQUIRE_THROWS_AS(SWideFrozenQuadTree::mapFile(path), std::runtime_error);
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  REQUIRE_THROWS_AS(TFrozenQuadTree<Rectangle>::mapFile(path), std::runtime_error);
+  std::filesystem::resize_file(path, 10);
+  REQUIRE_THROWS_AS(TFrozenQuadTree<Rectangle>::mapFile(path), std::runtime_error);
+  std::filesystem::remove(path);
+  REQUIRE_THROWS_AS(TFrozenQuadTree<Rectangle>::mapFile(path), std::runtime_error);
+}
+
+/**
+ * @brief Teste la lecture d'un jeu de données projeté en mémoire.
+ */
+TEST_CASE("TQuadTree.34-Data set loader test", "[dataset]") {
+  const auto path = std::filesystem::temp_directory_path() / "TQuadTree.34.dat";
+  auto rects = randomRectangles(1000, 0.05f, 34);
+  auto write = [&path](const std::vector<Rectangle>& items, uint64_t count, uint64_t depth) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const Rectangle& r : items)
+    {
+      const float values[] = { r.x1(), r.y1(), r.x2(), r.y2() };
+      file.write(reinterpret_cast<const char*>(values), sizeof(values));
+    }
+    file.write(reinterpret_cast<const char*>(&depth), sizeof(depth));
+    };
+  write(rects, rects.size(), 7);
+
+  {
+    CDataSet dataset(path);
+    REQUIRE(dataset.size() == rects.size());
+    REQUIRE(dataset.depth() == 7);
+    for (size_t i = 0; i < rects.size(); i++)
+      REQUIRE(Rectangle(dataset.records()[i].x1(), dataset.records()[i].y1(), dataset.records()[i].x2(), dataset.records()[i].y2()) == rects[i]);
+
+    //Les tranches couvrent tous les enregistrements, dans l'ordre
+    size_t chunks = 0, next = 0;
+    dataset.forEachChunk(300, [&](std::span<const SDataSetRecord> chunk) {
+      REQUIRE(chunk.data() == dataset.records().data() + next);
+      REQUIRE(chunk.size() == std::min<size_t>(300, rects.size() - next));
+      next += chunk.size();
+      chunks++;
+      });
+    REQUIRE(next == rects.size());
+    REQUIRE(chunks == 4);
+
+    //Chargement en bloc direct, par les enregistrements eux-mêmes ou convertis
+    QuadTree expected(rects, { 0.0f, 0.0f, 1.0f, 1.0f });
+    QuadTree qt(dataset.as<Rectangle>(), { 0.0f, 0.0f, 1.0f, 1.0f });
+    TQuadTree<SDataSetRecord> raw(dataset.records(), { 0.0f, 0.0f, 1.0f, 1.0f });
+    REQUIRE(qt.size() == expected.size());
+    REQUIRE(raw.size() == expected.size());
+    REQUIRE(qt.depth() == expected.depth());
+    REQUIRE(raw.depth() == expected.depth());
+    REQUIRE(sorted(qt.findColliding(subDataLimits)) == sorted(expected.findColliding(subDataLimits)));
+    REQUIRE(raw.findColliding(subDataLimits).size() == expected.findColliding(subDataLimits).size());
+
+    //Les enregistrements survivent au jeu de données tant qu'une copie existe
+    CDataSet copy = dataset;
+    dataset = CDataSet(copy);
+    REQUIRE(copy.records().data() == dataset.records().data());
+  }
+
+  write({}, 0, 3);
+  CDataSet empty(path);
+  REQUIRE(empty.empty());
+  REQUIRE(empty.depth() == 3);
+
+  //Fichiers absents, tronqués ou annonçant plus de rectangles qu'ils n'en contiennent
+  write(rects, rects.size() + 1, 7);
+  REQUIRE_THROWS_AS(CDataSet(path), std::runtime_error);
+  write(rects, rects.size(), 7);
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  REQUIRE_THROWS_AS(CDataSet(path), std::runtime_error);
+  std::filesystem::resize_file(path, 10);
+  REQUIRE_THROWS_AS(CDataSet(path), std::runtime_error);
+  std::filesystem::remove(path);
+  REQUIRE_THROWS_AS(CDataSet(path), std::runtime_error);
+}
+
+/**
+ * @brief Teste l'enregistrement et la relecture d'un jeu de données en version 2, et la détection des fichiers corrompus.
+ */
+TEST_CASE("TQuadTree.36-Data set format version 2 test", "[dataset]") {
+  const auto path = std::filesystem::temp_directory_path() / "TQuadTree.36.dat";
+  auto rects = randomRectangles(1000, 0.05f, 36);
+  const SLimits world = { -1.0f, -1.0f, 2.0f, 2.0f };
+  CDataSet::save(path, rects, world, 9, 300);
+
+  {
+    CDataSet dataset(path);
+    REQUIRE(dataset.version() == 2);
+    REQUIRE(dataset.size() == rects.size());
+    REQUIRE(dataset.depth() == 9);
+    REQUIRE(dataset.limits() == world);
+    REQUIRE(dataset.chunkSize() == 300);
+    REQUIRE(dataset.chunkCount() == 4);
+    REQUIRE(std::ranges::equal(dataset.as<Rectangle>(), rects));
+    REQUIRE(dataset.chunk(3).size() == 100);
+    REQUIRE(dataset.chunk(2).data() == dataset.records().data() + 600);
+    REQUIRE(dataset.verify());
+
+    //La répartition enregistrée est celle calculée sur les rectangles
+    SLimits extent = { rects[0].x1(), rects[0].y1(), rects[0].x2(), rects[0].y2() };
+    float maxWidth = 0.0f;
+    for (const Rectangle& r : rects)
+    {
+      extent = { std::min(extent.x1, r.x1()), std::min(extent.y1, r.y1()), std::max(extent.x2, r.x2()), std::max(extent.y2, r.y2()) };
+      maxWidth = std::max(maxWidth, r.x2() - r.x1());
+    }
+    REQUIRE(dataset.distribution().extent == extent);
+    REQUIRE(dataset.distribution().maxWidth == maxWidth);
+    REQUIRE(dataset.distribution().meanWidth > 0.0f);
+    REQUIRE(dataset.distribution().meanWidth <= maxWidth);
+
+    size_t chunks = 0;
+    dataset.forEachChunk([&](std::span<const SDataSetRecord> chunk) {
+      REQUIRE(chunk.data() == dataset.chunk(chunks).data());
+      chunks++;
+      });
+    REQUIRE(chunks == 4);
+  }
+
+  //Un rectangle modifié n'invalide que sa tranche
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(static_cast<std::streamoff>(128 + 700 * sizeof(SDataSetRecord)));
+    const float value = 0.5f;
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  {
+    CDataSet dataset(path);
+    REQUIRE(dataset.checkChunk(0));
+    REQUIRE(dataset.checkChunk(1));
+    REQUIRE_FALSE(dataset.checkChunk(2));
+    REQUIRE(dataset.checkChunk(3));
+    REQUIRE_FALSE(dataset.verify());
+  }
+
+  //Un en-tête modifié est refusé à l'ouverture
+  CDataSet::save(path, rects, world, 9, 300);
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(32);
+    const uint64_t depth = 10;
+    file.write(reinterpret_cast<const char*>(&depth), sizeof(depth));
+  }
+  REQUIRE_THROWS_AS(CDataSet(path), std::runtime_error);
+
+  //Fichiers tronqués
+  CDataSet::save(path, rects, world, 9, 300);
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+  REQUIRE_THROWS_AS(CDataSet(path), std::runtime_error);
+  std::filesystem::resize_file(path, 100);
+  REQUIRE_THROWS_AS(CDataSet(path), std::runtime_error);
+
+  //Jeu de données vide, et liste d'entrée parcourue en une seule passe
+  CDataSet::save(path, std::vector<Rectangle>(), world, 0);
+  {
+    CDataSet dataset(path);
+    REQUIRE(dataset.version() == 2);
+    REQUIRE(dataset.empty());
+    REQUIRE(dataset.chunkCount() == 0);
+    REQUIRE(std::isnan(dataset.distribution().extent.x1));
+    REQUIRE(dataset.verify());
+  }
+  std::list<Rectangle> list(rects.begin(), rects.end());
+  CDataSet::save(path, list, world, 9);
+  CDataSet dataset(path);
+  REQUIRE(dataset.chunkCount() == 1);
+  REQUIRE(std::ranges::equal(dataset.as<Rectangle>(), rects));
+  QuadTree qt(dataset.as<Rectangle>(), dataset.limits());
+  REQUIRE(qt.size() == rects.size());
+  std::filesystem::remove(path);
+}
+
+/**
+ * @brief Teste les comptages des sous-arbres au fil des insertions, retraits, déplacements et chargements en bloc.
+ *
+ * Les comptages sont vérifiés face à la recherche exhaustive avec les autres formes de requêtes (voir checkQuery).
+ */
+TEMPLATE_LIST_TEST_CASE("TQuadTree.37-QuadTree count test", "[count]", QuadTreePolicies) {
+  using QT = TQuadTree<Rectangle, TestType>;
+  QT empty;
+  checkRandomQueries(empty, std::vector<Rectangle>(), 37);
+  REQUIRE(empty.countColliding({ 0.0f, 0.0f, 1.0f, 1.0f }) == 0);
+
+  TRandomTree<TestType> fixture(5000, 0.05f, 37);
+  auto& [qt, rects, handles] = fixture;
+  checkRandomQueries(qt, rects, 38);
+
+  //Retraits avec fusion des enfants, mises à jour et déplacements
+  for (size_t i = 0; i < rects.size(); i += 3)
+    REQUIRE(qt.remove(handles[i]));
+  auto moved = randomRectangles(rects.size(), 0.02f, 38);
+  for (size_t i = 1; i < rects.size(); i += 3)
+    REQUIRE(qt.update(handles[i], moved[i]));
+  for (size_t i = 2; i < rects.size(); i += 3)
+    REQUIRE(qt.relocate(handles[i], moved[i], 0.01f));
+  std::vector<Rectangle> kept;
+  for (size_t i = 0; i < rects.size(); i++)
+    if (i % 3 != 0)
+      kept.push_back(moved[i]);
+  checkRandomQueries(qt, kept, 39);
+
+  //Une racine agrandie garde les comptages de sa descendance
+  if constexpr (TestType::growable)
+  {
+    for (Rectangle outside : { Rectangle(1.5f, 1.5f, 1.6f, 1.6f), Rectangle(-2.0f, 0.5f, -1.9f, 0.6f) })
+    {
+      qt.insert(outside);
+      kept.push_back(outside);
+    }
+    checkRandomQueries(qt, kept, 40);
+  }
+
+  qt.assign(rects);
+  checkRandomQueries(qt, rects, 41);
+  qt.clear();
+  checkRandomQueries(qt, std::vector<Rectangle>(), 42);
+
+  //Une zone qui couvre tout le QuadTree est comptée sans lire un seul élément
+  qt.assign(rects);
+  QT copy = qt;
+  REQUIRE(copy.countInscribed({ -1.0f, -1.0f, 2.0f, 2.0f }) == rects.size());
+  REQUIRE(copy.countColliding({ 2.0f, 2.0f, 3.0f, 3.0f }) == 0);
+}
+
+/**
+ * @brief Teste les requêtes dont la zone couvre des sous-arbres entiers, jusqu'à tout le QuadTree.
+ */
+TEMPLATE_LIST_TEST_CASE("TQuadTree.39-QuadTree covered subtrees test", "[cover]", QuadTreePolicies) {
+  TRandomTree<TestType> fixture(5000, 0.05f, 39);
+  auto& [qt, rects, handles] = fixture;
+  const TBruteForce kept(fixture.removeHalf());
+
+  //Des zones alignées sur les cellules couvrent des sous-arbres entiers, et la plus grande tout le QuadTree
+  const SLimits zones[] = { { -1.0f, -1.0f, 2.0f, 2.0f }, { 0.0f, 0.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.5f, 0.5f },
+    { 0.25f, 0.5f, 1.0f, 1.0f }, { 0.1f, 0.1f, 0.9f, 0.9f }, { 0.5f, 0.0f, 0.625f, 1.0f } };
+  for (const SLimits& limits : zones)
+  {
+    checkQuery(qt, kept, limits);
+
+    //Un parcours interrompu s'arrête aussi dans un noeud couvert
+    const size_t colliding = kept.colliding(limits).size();
+    size_t visited = 0;
+    const bool complete = qt.forEachColliding(limits, [&visited](const Rectangle&) { return ++visited < 100; });
+    REQUIRE(complete == (colliding < 100));
+    REQUIRE(visited == std::min<size_t>(colliding, 100));
+  }
+}
+
+/**
+ * @brief Teste la recherche des éléments qui contiennent un point, y compris sur les bords des cellules.
+ */
+TEMPLATE_LIST_TEST_CASE("TQuadTree.41-QuadTree point query test", "[containing]", QuadTreePolicies) {
+  TRandomTree<TestType> fixture(5000, 0.05f, 41);
+  auto& [qt, rects, handles] = fixture;
+  //Des rectangles dont les bords sont sur ceux des cellules
+  for (Rectangle aligned : { Rectangle(0.25f, 0.25f, 0.5f, 0.5f), Rectangle(0.5f, 0.5f, 0.5f, 0.5f), Rectangle(0.0f, 0.0f, 1.0f, 1.0f) })
+  {
+    qt.insert(aligned);
+    rects.push_back(aligned);
+  }
+  const TBruteForce oracle(rects);
+
+  std::default_random_engine dre(41);
+  std::uniform_real_distribution<float> urd(-0.1f, 1.1f);
+  std::vector<std::pair<float, float>> points = { { 0.5f, 0.5f }, { 0.25f, 0.25f }, { 0.0f, 0.0f }, { 1.0f, 1.0f },
+    { 0.5f, 0.3f }, { 0.375f, 0.5f }, { 2.0f, 0.5f } };
+  for (int i = 0; i < 200; i++)
+    points.emplace_back(urd(dre), urd(dre));
+  for (auto [x, y] : points)
+  {
+    //Un point est une zone réduite à lui-même
+    checkContaining(qt, oracle, x, y);
+    checkQuery(qt, oracle, SLimits{ x, y, x, y });
+  }
+}
+
+/**
+ * @brief Distance de Tchebychev d'un point au rectangle d'un élément, pour tester une distance fournie par l'utilisateur.
+ */
+struct SChebyshevDistance
+{
+  template <typename Limits, typename Coordinate>
+  Coordinate operator()(const Limits& bounds, Coordinate x, Coordinate y) const
+  {
+    return std::max({ bounds.x1 - x, x - bounds.x2, bounds.y1 - y, y - bounds.y2, Coordinate(0) });
+  }
+
+  template <typename Limits, typename Coordinate>
+  Coordinate bound(const Limits& cell, Coordinate x, Coordinate y) const
+  {
+    return (*this)(cell, x, y);
+  }
+};
+
+/**
+ * @brief Teste la recherche des k plus proches voisins, pour chaque politique et plusieurs distances.
+ */
+TEMPLATE_LIST_TEST_CASE("TQuadTree.43-QuadTree nearest neighbors test", "[nearest]", QuadTreePolicies) {
+  REQUIRE(TQuadTree<Rectangle, TestType>().findNearest(0.5f, 0.5f, 10).empty());
+  TRandomTree<TestType> fixture(3000, 0.05f, 43);
+  auto& [qt, rects, handles] = fixture;
+  const TBruteForce oracle(rects);
+
+  std::default_random_engine dre(43);
+  std::uniform_real_distribution<float> urd(-0.5f, 1.5f);
+  for (int i = 0; i < 30; i++)
+  {
+    const float x = urd(dre), y = urd(dre);
+    for (size_t k : { size_t(1), size_t(7), size_t(100) })
+    {
+      checkNearest(qt, oracle, x, y, k, SBoxDistance());
+      checkNearest(qt, oracle, x, y, k, SCentroidDistance());
+      checkNearest(qt, oracle, x, y, k, SChebyshevDistance());
+    }
+  }
+  REQUIRE(qt.findNearest(0.5f, 0.5f, 0).empty());
+  REQUIRE(qt.findNearest(0.5f, 0.5f, rects.size() + 10).size() == rects.size());
+
+  //Après des retraits, les sous-arbres vides sont ignorés
+  const TBruteForce kept(fixture.removeHalf());
+  checkNearest(qt, kept, 0.3f, 0.7f, 25, SBoxDistance());
+  checkNearest(qt, kept, 2.0f, -1.0f, 25, SCentroidDistance());
+}
+
+/**
+ * @brief Teste les formes de requête seules : disque, polygone convexe et rectangle tourné.
+ */
+TEST_CASE("TQuadTree.45-Query shapes test", "[shape]") {
+  const TCircle<> circle{ 0.5f, 0.5f, 0.25f };
+  REQUIRE(circle.x1() == 0.25f);
+  REQUIRE(circle.y2() == 0.75f);
+  REQUIRE(circle.intersects(SLimits{ 0.7f, 0.45f, 0.8f, 0.55f }));
+  REQUIRE(circle.intersects(SLimits{ 0.75f, 0.5f, 0.8f, 0.6f }));
+  //Le coin du rectangle englobant est hors du disque
+  REQUIRE_FALSE(circle.intersects(SLimits{ 0.0f, 0.0f, 0.3f, 0.3f }));
+  REQUIRE(circle.contains(SLimits{ 0.4f, 0.4f, 0.6f, 0.6f }));
+  REQUIRE_FALSE(circle.contains(SLimits{ 0.3f, 0.3f, 0.7f, 0.7f }));
+  REQUIRE(circle.contains(SLimits{ 0.5f, 0.5f, 0.5f, 0.5f }));
+  //Un rayon négatif retournerait le rectangle englobant, un rayon nul donne un point
+  REQUIRE_THROWS_AS(TCircle<>(0.5f, 0.5f, -0.1f), std::invalid_argument);
+  REQUIRE_THROWS_AS(TCircle<>(0.5f, 0.5f, std::numeric_limits<float>::quiet_NaN()), std::invalid_argument);
+  REQUIRE_THROWS_AS(TCircle<>(std::numeric_limits<float>::quiet_NaN(), 0.5f, 0.1f), std::invalid_argument);
+  const TCircle<> point(0.5f, 0.5f, 0.0f);
+  REQUIRE(point.x1() == point.x2());
+  REQUIRE(point.intersects(SLimits{ 0.4f, 0.4f, 0.6f, 0.6f }));
+  REQUIRE_FALSE(point.intersects(SLimits{ 0.6f, 0.6f, 0.7f, 0.7f }));
+
+  //Le même triangle dans les deux sens de parcours
+  for (bool reversed : { false, true })
+  {
+    std::vector<TConvexPolygon<>::SPoint> vertices = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f } };
+    if (reversed)
+      std::reverse(vertices.begin(), vertices.end());
+    const TConvexPolygon<> triangle(vertices);
+    REQUIRE(triangle.vertices() == vertices);
+    REQUIRE(triangle.x1() == 0.0f);
+    REQUIRE(triangle.x2() == 1.0f);
+    REQUIRE(triangle.intersects(SLimits{ 0.1f, 0.1f, 0.2f, 0.2f }));
+    REQUIRE(triangle.intersects(SLimits{ 0.5f, 0.5f, 0.9f, 0.9f }));
+    //Dans le rectangle englobant, mais au-delà de l'hypoténuse
+    REQUIRE_FALSE(triangle.intersects(SLimits{ 0.6f, 0.6f, 0.9f, 0.9f }));
+    REQUIRE_FALSE(triangle.intersects(SLimits{ -0.5f, -0.5f, -0.1f, 2.0f }));
+    REQUIRE(triangle.contains(SLimits{ 0.1f, 0.1f, 0.2f, 0.2f }));
+    REQUIRE(triangle.contains(SLimits{ 0.0f, 0.0f, 0.5f, 0.5f }));
+    REQUIRE_FALSE(triangle.contains(SLimits{ 0.1f, 0.1f, 0.6f, 0.6f }));
+  }
+
+  //Un rectangle tourné d'un quart de tour échange largeur et hauteur
+  const auto rotated = TConvexPolygon<double>::rotatedRectangle(0.5, 0.5, 0.4, 0.2, std::numbers::pi / 2);
+  REQUIRE(rotated.x1() == Catch::Approx(0.4));
+  REQUIRE(rotated.x2() == Catch::Approx(0.6));
+  REQUIRE(rotated.y1() == Catch::Approx(0.3));
+  REQUIRE(rotated.y2() == Catch::Approx(0.7));
+  const auto diamond = TConvexPolygon<>::rotatedRectangle(0.5f, 0.5f, 0.5f, 0.5f, std::numbers::pi_v<float> / 4);
+  REQUIRE(diamond.intersects(SLimits{ 0.45f, 0.45f, 0.55f, 0.55f }));
+  REQUIRE_FALSE(diamond.intersects(SLimits{ 0.0f, 0.0f, 0.2f, 0.2f }));
+  REQUIRE_FALSE(diamond.contains(SLimits{ 0.3f, 0.3f, 0.7f, 0.7f }));
+
+  using SPoint = TConvexPolygon<>::SPoint;
+  REQUIRE_THROWS_AS(TConvexPolygon<>({ { 0.0f, 0.0f }, { 1.0f, 0.0f } }), std::invalid_argument);
+  REQUIRE_THROWS_AS(TConvexPolygon<>({ { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 2.0f, 0.0f } }), std::invalid_argument);
+  REQUIRE_THROWS_AS(TConvexPolygon<>({ { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.2f, 0.2f }, { 0.0f, 1.0f } }), std::invalid_argument);
+  REQUIRE_THROWS_AS(TConvexPolygon<>({ { 0.0f, 0.0f }, { 1.0f, 0.0f }, SPoint{ 0.0f, std::numeric_limits<float>::infinity() } }), std::invalid_argument);
+  //Un pentagramme tourne toujours du même côté, mais son contour se croise : il fait deux tours
+  std::vector<SPoint> pentagram, pentagon;
+  for (int i = 0; i < 5; i++)
+  {
+    const float star = i * 4 * std::numbers::pi_v<float> / 5;
+    const float convex = i * 2 * std::numbers::pi_v<float> / 5;
+    pentagram.push_back({ 0.5f + 0.4f * std::cos(star), 0.5f + 0.4f * std::sin(star) });
+    pentagon.push_back({ 0.5f + 0.4f * std::cos(convex), 0.5f + 0.4f * std::sin(convex) });
+  }
+  REQUIRE_THROWS_AS(TConvexPolygon<>(pentagram), std::invalid_argument);
+  std::reverse(pentagram.begin(), pentagram.end());
+  REQUIRE_THROWS_AS(TConvexPolygon<>(pentagram), std::invalid_argument);
+  REQUIRE_NOTHROW(TConvexPolygon<>(pentagon));
+}
+
+/**
+ * @brief Les politiques des tests de requêtes, et des coordonnées double pour les formes de requête.
+ */
+using ShapeQueryPolicies = decltype(std::tuple_cat(std::declval<QuadTreePolicies>(), std::declval<std::tuple<SDoublePolicy>>()));
+
+/**
+ * @brief Teste les requêtes sur un disque et sur un polygone convexe, pour chaque politique.
+ *
+ * Les résultats sont vérifiés face à un test exact de tous les éléments (voir TBruteForce).
+ */
+TEMPLATE_LIST_TEST_CASE("TQuadTree.46-QuadTree shape query test", "[shape]", ShapeQueryPolicies) {
+  using QT = TQuadTree<Rectangle, TestType>;
+  using circle = typename QT::circle_type;
+  using polygon = typename QT::polygon_type;
+  using coordinate = typename QT::coordinate;
+  REQUIRE(QT().findColliding(circle{ 0.5f, 0.5f, 1.0f }).empty());
+  TRandomTree<TestType> fixture(5000, 0.05f, 46);
+  auto& [qt, rects, handles] = fixture;
+  const TBruteForce oracle(rects);
+
+  //Des formes qui couvrent tout, rien, et des cellules entières
+  checkQuery(qt, oracle, circle{ 0.5f, 0.5f, 1.0f });
+  checkQuery(qt, oracle, circle{ 3.0f, 3.0f, 0.5f });
+  checkQuery(qt, oracle, polygon({ { -1.0f, -1.0f }, { 2.0f, -1.0f }, { 2.0f, 2.0f }, { -1.0f, 2.0f } }));
+  checkQuery(qt, oracle, polygon({ { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f } }));
+  std::default_random_engine dre(46);
+  std::uniform_real_distribution<coordinate> position(-0.2f, 1.2f);
+  std::uniform_real_distribution<coordinate> size(0.01f, 0.6f);
+  std::uniform_real_distribution<coordinate> angle(0.0f, std::numbers::pi_v<coordinate>);
+  for (int i = 0; i < 50; i++)
+  {
+    checkQuery(qt, oracle, circle{ position(dre), position(dre), size(dre) });
+    checkQuery(qt, oracle, polygon::rotatedRectangle(position(dre), position(dre), size(dre), size(dre), angle(dre)));
+  }
+
+  //Un rectangle non tourné donne les mêmes résultats qu'une zone rectangulaire
+  const auto viewport = polygon::rotatedRectangle(0.4f, 0.6f, 0.5f, 0.3f, 0.0f);
+  const typename QT::limits_type limits{ viewport.x1(), viewport.y1(), viewport.x2(), viewport.y2() };
+  REQUIRE(qt.countColliding(viewport) == qt.countColliding(limits));
+  REQUIRE(qt.countInscribed(viewport) == qt.countInscribed(limits));
+
+  //Après des retraits, les sous-arbres vides sont ignorés
+  const TBruteForce kept(fixture.removeHalf());
+  checkQuery(qt, kept, circle{ 0.3f, 0.7f, 0.3f });
+  checkQuery(qt, kept, polygon::rotatedRectangle(0.5f, 0.5f, 0.8f, 0.2f, 1.0f));
+}
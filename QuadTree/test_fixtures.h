@@ -0,0 +1,468 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "catch_amalgamated.hpp"
+#include "QuadTree.h"
+
+//Jeu de données et lecteur définis dans tests.cpp
+extern const char* datasetFilename;
+void readDataSet(size_t& depth, size_t& datasetSize, std::function<void(float x1, float y1, float x2, float y2)> callback);
+
+const SLimits subDataLimits = { 0.42f, 0.43f, 0.72f, 0.73f };
+
+/**
+ * @brief Politique de subdivision paramétrable, pour les tests et les benchmarks.
+ */
+template <size_t BucketCapacity, size_t MaxDepth>
+struct TTestPolicy : SQuadTreePolicy
+{
+  static constexpr size_t bucketCapacity = BucketCapacity;
+  static constexpr size_t maxDepth = MaxDepth;
+};
+
+/**
+ * @brief Politique de QuadTree lâche, pour les tests et les benchmarks.
+ */
+struct SLoosePolicy : SQuadTreePolicy
+{
+  static constexpr float looseness = 2.0f;
+};
+
+/**
+ * @brief Politique de QuadTree lâche avec des feuilles de capacité 16.
+ */
+struct SLooseBucketPolicy : SQuadTreePolicy
+{
+  static constexpr float looseness = 1.5f;
+  static constexpr size_t bucketCapacity = 16;
+};
+
+/**
+ * @brief Politique dont les noeuds stockent leurs premiers éléments en eux-mêmes, pour les tests et les benchmarks.
+ */
+template <size_t BucketCapacity, size_t InlineCapacity>
+struct TInlinePolicy : SQuadTreePolicy
+{
+  static constexpr size_t bucketCapacity = BucketCapacity;
+  static constexpr size_t inlineCapacity = InlineCapacity;
+};
+
+/**
+ * @brief Politique d'un QuadTree dont la racine s'agrandit pour accueillir les éléments en dehors de ses limites.
+ */
+struct SGrowablePolicy : SQuadTreePolicy
+{
+  static constexpr bool growable = true;
+};
+
+/**
+ * @brief Politique d'un QuadTree lâche et extensible, avec une capacité de feuilles.
+ */
+struct SLooseGrowablePolicy : SQuadTreePolicy
+{
+  static constexpr float looseness = 2.0f;
+  static constexpr size_t bucketCapacity = 16;
+  static constexpr bool growable = true;
+};
+
+/**
+ * @brief Politique d'un QuadTree avec limites compressées.
+ */
+struct SQuantizedPolicy : SQuadTreePolicy
+{
+  static constexpr bool quantized = true;
+};
+
+/**
+ * @brief Politique d'un QuadTree en coordonnées double.
+ */
+struct SDoublePolicy : SQuadTreePolicy
+{
+  using coordinate = double;
+};
+
+/**
+ * @brief Les politiques sur lesquelles sont répétés les tests des requêtes et des modifications.
+ *
+ * Une de chaque sorte : strict, avec capacité des feuilles, avec profondeur maximale, lâche, extensible et compressé.
+ */
+using QuadTreePolicies = std::tuple<SQuadTreePolicy, TTestPolicy<8, std::numeric_limits<size_t>::max()>, TTestPolicy<16, 8>,
+  TTestPolicy<0, 4>, SLoosePolicy, SLooseBucketPolicy, SLooseGrowablePolicy, SQuantizedPolicy>;
+
+/**
+ * @brief Génère des rectangles de taille et de position aléatoires dans la surface unité.
+ *
+ * @param count Nombre de rectangles à générer.
+ * @param maxSize Taille maximale d'un côté de rectangle.
+ * @param seed Graine du générateur, pour obtenir deux fois la même série.
+ */
+inline std::vector<Rectangle> randomRectangles(size_t count, float maxSize, unsigned int seed)
+{
+  std::default_random_engine dre(seed);
+  std::uniform_real_distribution<float> urd(0.0f, 1.0f);
+  std::vector<Rectangle> rects;
+  rects.reserve(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    float width = urd(dre) * maxSize;
+    float height = urd(dre) * maxSize;
+    float x1 = urd(dre) * (1.0f - width);
+    float y1 = urd(dre) * (1.0f - height);
+    rects.emplace_back(x1, y1, x1 + width, y1 + height);
+  }
+  return rects;
+}
+
+/**
+ * @brief Génère des zones de requête aléatoires, débordant de la surface unité, de taille nulle à presque toute la surface.
+ */
+inline std::vector<SLimits> randomZones(size_t count, unsigned int seed)
+{
+  std::default_random_engine dre(seed);
+  std::uniform_real_distribution<float> position(-0.2f, 1.0f);
+  std::uniform_real_distribution<float> extent(0.0f, 0.8f);
+  std::vector<SLimits> zones;
+  zones.reserve(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    const float x = position(dre), y = position(dre);
+    zones.push_back({ x, y, x + extent(dre), y + extent(dre) });
+  }
+  return zones;
+}
+
+/**
+ * @brief Convertit une coordonnée de la surface unité vers le type de coordonnées d'un tableau de limites.
+ *
+ * Les coordonnées entières sont ramenées sur une grille de 60000 pas, les coordonnées hors de la surface unité y étant bornées.
+ */
+template <typename Coordinate>
+Coordinate toCoordinate(float value)
+{
+  if constexpr (std::is_integral_v<Coordinate>)
+    return static_cast<Coordinate>(std::clamp(value, 0.0f, 1.0f) * 60000.0f);
+  else
+    return static_cast<Coordinate>(value);
+}
+
+/**
+ * @brief Remplit un tableau de limites avec des rectangles aléatoires.
+ */
+template <typename Coordinate = float>
+TBoundsArray<Coordinate> randomBounds(size_t count, float maxSize, unsigned int seed)
+{
+  TBoundsArray<Coordinate> bounds;
+  bounds.reserve(count);
+  for (const auto& r : randomRectangles(count, maxSize, seed))
+    bounds.push_back(toCoordinate<Coordinate>(r.x1()), toCoordinate<Coordinate>(r.y1()),
+                     toCoordinate<Coordinate>(r.x2()), toCoordinate<Coordinate>(r.y2()));
+  return bounds;
+}
+
+/**
+ * @brief Retourne une liste triée, pour comparer des résultats de requêtes quel que soit leur ordre.
+ */
+template <typename T>
+std::vector<T> sorted(std::vector<T> v)
+{
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+/**
+ * @brief Retourne les éléments désignés par une liste d'adresses.
+ */
+template <typename T>
+std::vector<T> dereferenced(const std::vector<const T*>& pointers)
+{
+  std::vector<T> v;
+  v.reserve(pointers.size());
+  for (const T* p : pointers)
+    v.push_back(*p);
+  return v;
+}
+
+/**
+ * @brief Oracle de recherche exhaustive : les résultats attendus des requêtes, calculés en testant chaque rectangle.
+ *
+ * Toutes les listes retournées sont triées (voir sorted). Construit implicitement à partir de la liste des éléments
+ * que le QuadTree vérifié doit contenir.
+ *
+ * @tparam T Le type des éléments, ordonné pour le tri.
+ */
+template <typename T = Rectangle>
+class TBruteForce
+{
+  std::vector<T> m_Rects; ///< Les éléments attendus, triés
+
+  /**
+   * @brief Retourne les limites d'un élément dans le type de limites d'un QuadTree.
+   */
+  template <typename Limits>
+  static Limits boundsOf(const T& r)
+  {
+    using coordinate = decltype(Limits::x1);
+    return { coordinate(r.x1()), coordinate(r.y1()), coordinate(r.x2()), coordinate(r.y2()) };
+  }
+
+  /**
+   * @brief Retourne les éléments dont les limites satisfont un prédicat.
+   */
+  template <typename Limits, typename Predicate>
+  std::vector<T> select(Predicate predicate) const
+  {
+    std::vector<T> result;
+    for (const T& r : m_Rects)
+      if (predicate(boundsOf<Limits>(r)))
+        result.push_back(r);
+    return result;
+  }
+
+public:
+  /**
+   * @brief Constructeur de la classe TBruteForce.
+   *
+   * @param rects Les éléments que le QuadTree vérifié doit contenir.
+   */
+  TBruteForce(std::vector<T> rects)
+    : m_Rects(sorted(std::move(rects)))
+  {
+  }
+
+  /**
+   * @brief Retourne tous les éléments attendus.
+   */
+  const std::vector<T>& all() const
+  {
+    return m_Rects;
+  }
+
+  /**
+   * @brief Retourne les éléments en collision avec une zone : des limites, ou une forme (voir QueryShape).
+   *
+   * @tparam Limits Le type des limites du QuadTree vérifié, celles qu'il passe aux formes.
+   */
+  template <typename Limits = SLimits, typename Zone>
+  std::vector<T> colliding(const Zone& zone) const
+  {
+    return select<Limits>([&zone](const Limits& b) {
+      if constexpr (requires { zone.intersects(b); })
+        return static_cast<bool>(zone.intersects(b));
+      else
+        return b.x1 <= zone.x2 && b.x2 >= zone.x1 && b.y1 <= zone.y2 && b.y2 >= zone.y1;
+      });
+  }
+
+  /**
+   * @brief Retourne les éléments totalement inclus dans une zone : des limites, ou une forme (voir QueryShape).
+   *
+   * @tparam Limits Le type des limites du QuadTree vérifié, celles qu'il passe aux formes.
+   */
+  template <typename Limits = SLimits, typename Zone>
+  std::vector<T> inscribed(const Zone& zone) const
+  {
+    return select<Limits>([&zone](const Limits& b) {
+      if constexpr (requires { zone.contains(b); })
+        return static_cast<bool>(zone.contains(b));
+      else
+        return b.x1 >= zone.x1 && b.y1 >= zone.y1 && b.x2 <= zone.x2 && b.y2 <= zone.y2;
+      });
+  }
+
+  /**
+   * @brief Retourne les k plus petites distances d'un point aux éléments, dans l'ordre croissant.
+   */
+  template <typename Metric>
+  std::vector<float> nearestDistances(float x, float y, size_t k, const Metric& metric) const
+  {
+    std::vector<float> distances;
+    for (const T& r : m_Rects)
+      distances.push_back(metric(boundsOf<SLimits>(r), x, y));
+    std::sort(distances.begin(), distances.end());
+    distances.resize(std::min(k, distances.size()));
+    return distances;
+  }
+};
+
+/**
+ * @brief Vérifie une requête sous toutes les formes proposées par le QuadTree par comparaison avec l'oracle :
+ * listes, itérateur de sortie, adresses, itérateurs de requête, visiteurs (avec interruption) et comptages.
+ *
+ * @param qt Le QuadTree à vérifier, un TQuadTree ou un TFrozenQuadTree.
+ * @param oracle Les éléments que le QuadTree doit contenir.
+ * @param zone La zone de la requête : des limites (converties dans le type de limites du QuadTree) ou une forme.
+ */
+template <typename QT, typename Zone>
+void checkQuery(QT& qt, const TBruteForce<typename QT::container::value_type>& oracle, const Zone& zone)
+{
+  using value_type = typename QT::container::value_type;
+  using limits_type = typename QT::limits_type;
+  using coordinate = decltype(limits_type::x1);
+  constexpr bool shape = requires(const limits_type& b) { zone.intersects(b); };
+  const auto query = [&zone]() {
+    if constexpr (shape)
+      return zone;
+    else
+      return limits_type{ coordinate(zone.x1), coordinate(zone.y1), coordinate(zone.x2), coordinate(zone.y2) };
+    }();
+  const std::vector<value_type> colliding = oracle.template colliding<limits_type>(query);
+  const std::vector<value_type> inscribed = oracle.template inscribed<limits_type>(query);
+
+  REQUIRE(sorted(qt.findColliding(query)) == colliding);
+  REQUIRE(sorted(qt.findInscribed(query)) == inscribed);
+  std::vector<const value_type*> pointers;
+  qt.findColliding(query, pointers);
+  REQUIRE(sorted(dereferenced(pointers)) == colliding);
+  pointers.clear();
+  qt.findInscribed(query, pointers);
+  REQUIRE(sorted(dereferenced(pointers)) == inscribed);
+  if constexpr (!shape)
+  {
+    std::vector<value_type> copied;
+    qt.findColliding(query, std::back_inserter(copied));
+    REQUIRE(sorted(copied) == colliding);
+    copied.clear();
+    qt.findInscribed(query, std::back_inserter(copied));
+    REQUIRE(sorted(copied) == inscribed);
+  }
+  if constexpr (requires { qt.beginColliding(query); })
+  {
+    REQUIRE(sorted(std::vector<value_type>(qt.beginColliding(query), qt.end())) == colliding);
+    REQUIRE(sorted(std::vector<value_type>(qt.beginInscribed(query), qt.end())) == inscribed);
+  }
+  if constexpr (requires { qt.countColliding(query); })
+  {
+    REQUIRE(qt.countColliding(query) == colliding.size());
+    REQUIRE(qt.countInscribed(query) == inscribed.size());
+  }
+
+  size_t visited = 0;
+  REQUIRE(qt.forEachColliding(query, [&visited](const value_type&) { ++visited; }));
+  REQUIRE(visited == colliding.size());
+  if (inscribed.size() > 1)
+  {
+    visited = 0;
+    REQUIRE_FALSE(qt.forEachInscribed(query, [&visited](const value_type&) { return ++visited < 1; }));
+    REQUIRE(visited == 1);
+  }
+}
+
+/**
+ * @brief Vérifie le contenu d'un QuadTree puis une requête par comparaison avec l'oracle (voir checkQuery).
+ *
+ * @param qt Le QuadTree à vérifier, un TQuadTree ou un TFrozenQuadTree.
+ * @param oracle Les éléments que le QuadTree doit contenir.
+ * @param limits Les limites de la requête, converties dans le type de limites du QuadTree.
+ */
+template <typename QT, typename Zone = SLimits>
+void checkQueries(QT& qt, const TBruteForce<typename QT::container::value_type>& oracle, const Zone& limits)
+{
+  REQUIRE(qt.size() == oracle.all().size());
+  REQUIRE(qt.empty() == oracle.all().empty());
+  REQUIRE(sorted(qt.getAll()) == oracle.all());
+  if constexpr (requires { qt.begin(); })
+    REQUIRE(sorted(std::vector<typename QT::container::value_type>(qt.begin(), qt.end())) == oracle.all());
+  checkQuery(qt, oracle, limits);
+}
+
+/**
+ * @brief Vérifie le contenu d'un QuadTree puis des requêtes sur des zones aléatoires et sur ses limites (voir randomZones).
+ */
+template <typename QT>
+void checkRandomQueries(QT& qt, const TBruteForce<typename QT::container::value_type>& oracle, unsigned int seed)
+{
+  checkQueries(qt, oracle, qt.limits());
+  for (const SLimits& zone : randomZones(50, seed))
+    checkQuery(qt, oracle, zone);
+}
+
+/**
+ * @brief Vérifie la recherche des éléments qui contiennent un point par comparaison avec l'oracle.
+ */
+template <typename QT>
+void checkContaining(const QT& qt, const TBruteForce<typename QT::container::value_type>& oracle, float x, float y)
+{
+  const std::vector<Rectangle> expected = oracle.colliding(SLimits{ x, y, x, y });
+  REQUIRE(sorted(qt.findContaining(x, y)) == expected);
+  std::vector<const Rectangle*> pointers;
+  qt.findContaining(x, y, pointers);
+  REQUIRE(sorted(dereferenced(pointers)) == expected);
+  size_t visited = 0;
+  REQUIRE(qt.forEachContaining(x, y, [&visited](const Rectangle&) { ++visited; }));
+  REQUIRE(visited == expected.size());
+  if (expected.size() > 1)
+  {
+    visited = 0;
+    REQUIRE_FALSE(qt.forEachContaining(x, y, [&visited](const Rectangle&) { return ++visited < 1; }));
+    REQUIRE(visited == 1);
+  }
+}
+
+/**
+ * @brief Vérifie les k plus proches voisins d'un point par comparaison avec l'oracle.
+ *
+ * À distance égale, l'ordre des éléments n'est pas défini : ce sont les distances qui sont comparées.
+ */
+template <typename QT, typename Metric>
+void checkNearest(const QT& qt, const TBruteForce<typename QT::container::value_type>& oracle, float x, float y, size_t k, const Metric& metric)
+{
+  auto nearest = qt.findNearest(x, y, k, metric);
+  std::vector<float> distances;
+  for (const Rectangle& r : nearest)
+    distances.push_back(metric(SLimits{ r.x1(), r.y1(), r.x2(), r.y2() }, x, y));
+  REQUIRE(distances == oracle.nearestDistances(x, y, k, metric));
+  std::vector<const Rectangle*> pointers;
+  qt.findNearest(x, y, k, pointers, metric);
+  REQUIRE(dereferenced(pointers) == nearest);
+}
+
+/**
+ * @brief QuadTree rempli de rectangles aléatoires insérés avec un identifiant, point de départ des tests sur plusieurs politiques.
+ *
+ * @tparam Policy La politique du QuadTree (voir QuadTreePolicies).
+ */
+template <typename Policy>
+struct TRandomTree
+{
+  using tree_type = TQuadTree<Rectangle, Policy>;
+
+  tree_type qt;                                     ///< Le QuadTree
+  std::vector<Rectangle> rects;                     ///< Les rectangles insérés, dans l'ordre d'insertion
+  std::vector<typename tree_type::handle> handles;  ///< Leurs identifiants, dans le même ordre
+
+  /**
+   * @brief Constructeur de la classe TRandomTree (voir randomRectangles).
+   */
+  TRandomTree(size_t count, float maxSize, unsigned int seed)
+    : rects(randomRectangles(count, maxSize, seed))
+  {
+    handles.reserve(rects.size());
+    for (const auto& rect : rects)
+      handles.push_back(qt.insertWithHandle(rect));
+  }
+
+  /**
+   * @brief Retire par égalité un rectangle sur deux, ceux d'index pair.
+   *
+   * @return Les rectangles restants.
+   */
+  std::vector<Rectangle> removeHalf()
+  {
+    std::vector<Rectangle> kept;
+    for (size_t i = 0; i < rects.size(); i++)
+    {
+      if (i % 2 == 0)
+        qt.remove(rects[i]);
+      else
+        kept.push_back(rects[i]);
+    }
+    return kept;
+  }
+};